@@ -24,6 +24,7 @@
 #include <G3D/AABox.h>
 
 #include "Define.h"
+#include "MappedArray.h"
 
 #include <stdexcept>
 #include <vector>
@@ -72,11 +73,9 @@ class TC_COMMON_API BIH
     private:
         void init_empty()
         {
-            tree.clear();
             objects.clear();
             // create space for the first node
-            tree.push_back(3u << 30u); // dummy leaf
-            tree.insert(tree.end(), 2, 0);
+            tree.assign({ 3u << 30u, 0, 0 }); // dummy leaf
         }
     public:
         BIH() { init_empty(); }
@@ -107,15 +106,14 @@ class TC_COMMON_API BIH
             if (printStats)
                 stats.printStats();
 
-            objects.resize(dat.numPrims);
-            for (uint32 i=0; i<dat.numPrims; ++i)
-                objects[i] = dat.indices[i];
+            objects.assign(std::vector<uint32>(dat.indices, dat.indices + dat.numPrims));
             //nObjects = dat.numPrims;
-            tree = tempTree;
+            tree.assign(std::move(tempTree));
             delete[] dat.primBound;
             delete[] dat.indices;
         }
         uint32 primCount() const { return uint32(objects.size()); }
+        std::size_t GetMemoryUsage() const { return tree.GetMemoryUsage() + objects.GetMemoryUsage(); }
 
         template<typename RayCallback>
         void intersectRay(const G3D::Ray &r, RayCallback& intersectCallback, float &maxDist, bool stopAtFirst=false) const
@@ -336,10 +334,11 @@ class TC_COMMON_API BIH
 
         bool writeToFile(FILE* wf) const;
         bool readFromFile(FILE* rf);
+        bool readFromFile(MappedFileReader& reader);
 
     protected:
-        std::vector<uint32> tree;
-        std::vector<uint32> objects;
+        MappedArray<uint32> tree;
+        MappedArray<uint32> objects;
         G3D::AABox bounds;
 
         struct buildData
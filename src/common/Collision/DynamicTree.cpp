@@ -28,6 +28,7 @@
 #include <G3D/AABox.h>
 #include <G3D/Ray.h>
 #include <G3D/Vector3.h>
+#include <algorithm>
 
 using VMAP::ModelInstance;
 
@@ -245,6 +246,28 @@ float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist,
         return -G3D::finf();
 }
 
+void DynamicMapTree::getHeights(float const* x, float const* y, float const* z, float* heights, std::size_t count, float maxSearchDist, PhaseShift const& phaseShift) const
+{
+    std::fill(heights, heights + count, -G3D::finf());
+    if (impl->empty())
+        return;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        DynTreeImpl::Cell cell = DynTreeImpl::Cell::ComputeCell(x[i], y[i]);
+        if (!cell.isValid() || !impl->nodes[cell.x][cell.y])
+            continue;
+
+        float searchDist = maxSearchDist;
+        G3D::Vector3 v(x[i], y[i], z[i] + 0.5f);
+        G3D::Ray r(v, G3D::Vector3(0, 0, -1));
+        DynamicTreeIntersectionCallback callback(phaseShift);
+        impl->nodes[cell.x][cell.y]->intersectRay(r, callback, searchDist);
+        if (callback.didHit())
+            heights[i] = v.z - searchDist;
+    }
+}
+
 bool DynamicMapTree::getAreaInfo(float x, float y, float& z, PhaseShift const& phaseShift, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const
 {
     G3D::Vector3 v(x, y, z + 0.5f);
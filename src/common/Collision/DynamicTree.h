@@ -21,6 +21,7 @@
 #define _DYNTREE_H
 
 #include "Define.h"
+#include <cstddef>
 
 namespace G3D
 {
@@ -46,6 +47,8 @@ public:
     bool getObjectHitPos(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos, G3D::Vector3& resultHitPos, float modifyDist, PhaseShift const& phaseShift) const;
 
     float getHeight(float x, float y, float z, float maxSearchDist, PhaseShift const& phaseShift) const;
+    // getHeight for count points, cells without gameobject models are skipped without casting rays
+    void getHeights(float const* x, float const* y, float const* z, float* heights, std::size_t count, float maxSearchDist, PhaseShift const& phaseShift) const;
     bool getAreaInfo(float x, float y, float& z, PhaseShift const& phaseShift, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const;
 
     void insert(const GameObjectModel&);
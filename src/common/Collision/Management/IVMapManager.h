@@ -19,6 +19,8 @@
 #ifndef _IVMAPMANAGER_H
 #define _IVMAPMANAGER_H
 
+#include <atomic>
+#include <cstddef>
 #include <string>
 #include "Define.h"
 #include "ModelIgnoreFlags.h"
@@ -55,9 +57,14 @@ namespace VMAP
         private:
             bool iEnableLineOfSightCalc;
             bool iEnableHeightCalc;
+            std::atomic<uint32> iTileGeneration;
+
+        protected:
+            // results computed before a tile was loaded or unloaded are outdated
+            void onTilesChanged() { ++iTileGeneration; }
 
         public:
-            IVMapManager() : iEnableLineOfSightCalc(true), iEnableHeightCalc(true) { }
+            IVMapManager() : iEnableLineOfSightCalc(true), iEnableHeightCalc(true), iTileGeneration(0) { }
 
             virtual ~IVMapManager(void) { }
 
@@ -70,6 +77,8 @@ namespace VMAP
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, ModelIgnoreFlags ignoreFlags) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
+            // getHeight for count points of the same map, the map tree is only looked up once
+            virtual void getHeights(unsigned int pMapId, float const* x, float const* y, float const* z, float* heights, std::size_t count, float maxSearchDist) = 0;
             /**
             test if we hit an object. return true if we hit one. rx, ry, rz will hold the hit position or the dest position, if no intersection was found
             return a position, that is pReduceDist closer to the origin
@@ -95,6 +104,11 @@ namespace VMAP
             bool isHeightCalcEnabled() const { return(iEnableHeightCalc); }
             bool isMapLoadingEnabled() const { return(iEnableLineOfSightCalc || iEnableHeightCalc  ); }
 
+            /**
+            Changes every time tiles are loaded or unloaded on any map, lets callers tell when cached results expire
+            */
+            uint32 getTileGeneration() const { return iTileGeneration.load(std::memory_order_acquire); }
+
             virtual std::string getDirFileName(unsigned int pMapId, int x, int y) const =0;
             /**
             Query world model area info.
@@ -20,12 +20,38 @@
 #include "Errors.h"
 #include "Log.h"
 #include "MapDefines.h"
+#include <algorithm>
 
 namespace MMAP
 {
     static char const* const MAP_FILE_NAME_FORMAT = "%smmaps/%04i.mmap";
     static char const* const TILE_FILE_NAME_FORMAT = "%smmaps/%04i%02i%02i.mmtile";
 
+    static int const NAV_MESH_QUERY_MAX_NODES = 1024;
+
+    namespace
+    {
+        // queries of one thread, each bound to the mesh it was last initialized for
+        struct ThreadNavMeshQueries
+        {
+            struct Entry
+            {
+                uint32 Serial;
+                dtNavMeshQuery* Query;
+            };
+
+            ~ThreadNavMeshQueries()
+            {
+                for (std::pair<uint32 const, Entry>& entry : Queries)
+                    dtFreeNavMeshQuery(entry.second.Query);
+            }
+
+            std::unordered_map<uint32 /*mapId*/, Entry> Queries;
+        };
+
+        thread_local ThreadNavMeshQueries threadNavMeshQueries;
+    }
+
     // ######################## MMapManager ########################
     MMapManager::~MMapManager()
     {
@@ -39,6 +65,7 @@ namespace MMAP
     void MMapManager::InitializeThreadUnsafe(std::unordered_map<uint32, std::vector<uint32>> const& mapData)
     {
         childMapData = mapData;
+        std::unique_lock<std::shared_mutex> lock(loadedMMapsLock);
         // the caller must pass the list of all mapIds that will be used in the VMapManager2 lifetime
         for (std::pair<uint32 const, std::vector<uint32>> const& mapId : mapData)
         {
@@ -50,31 +77,31 @@ namespace MMAP
         thread_safe_environment = false;
     }
 
-    MMapDataSet::const_iterator MMapManager::GetMMapData(uint32 mapId) const
+    MMapData* MMapManager::GetMMapData(uint32 mapId) const
     {
-        // return the iterator if found or end() if not found/NULL
+        std::shared_lock<std::shared_mutex> lock(loadedMMapsLock);
         MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
-        if (itr != loadedMMaps.cend() && !itr->second)
-            itr = loadedMMaps.cend();
-
-        return itr;
+        return itr != loadedMMaps.end() ? itr->second : nullptr;
     }
 
     bool MMapManager::loadMapData(std::string const& basePath, uint32 mapId)
     {
-        // we already have this map loaded?
-        MMapDataSet::iterator itr = loadedMMaps.find(mapId);
-        if (itr != loadedMMaps.end())
         {
-            if (itr->second)
-                return true;
-        }
-        else
-        {
-            if (thread_safe_environment)
-                itr = loadedMMaps.insert(MMapDataSet::value_type(mapId, nullptr)).first;
+            std::unique_lock<std::shared_mutex> lock(loadedMMapsLock);
+            // we already have this map loaded?
+            MMapDataSet::iterator itr = loadedMMaps.find(mapId);
+            if (itr != loadedMMaps.end())
+            {
+                if (itr->second)
+                    return true;
+            }
             else
-                ASSERT(false, "Invalid mapId %u passed to MMapManager after startup in thread unsafe environment", mapId);
+            {
+                if (thread_safe_environment)
+                    loadedMMaps.insert(MMapDataSet::value_type(mapId, nullptr));
+                else
+                    ASSERT(false, "Invalid mapId %u passed to MMapManager after startup in thread unsafe environment", mapId);
+            }
         }
 
         // load and init dtNavMesh - read parameters from file
@@ -107,9 +134,10 @@ namespace MMAP
         TC_LOG_DEBUG("maps", "MMAP:loadMapData: Loaded %04i.mmap", mapId);
 
         // store inside our map list
-        MMapData* mmap_data = new MMapData(mesh);
+        MMapData* mmap_data = new MMapData(mesh, ++nextMeshSerial);
 
-        itr->second = mmap_data;
+        std::unique_lock<std::shared_mutex> lock(loadedMMapsLock);
+        loadedMMaps[mapId] = mmap_data;
         return true;
     }
 
@@ -118,6 +146,11 @@ namespace MMAP
         return uint32(x << 16 | y);
     }
 
+    std::string MMapManager::getTileFileName(std::string const& basePath, uint32 mapId, int32 x, int32 y)
+    {
+        return Trinity::StringFormat(TILE_FILE_NAME_FORMAT, basePath.c_str(), mapId, x, y);
+    }
+
     bool MMapManager::loadMap(std::string const& basePath, uint32 mapId, int32 x, int32 y)
     {
         if (!loadMapImpl(basePath, mapId, x, y))
@@ -140,23 +173,35 @@ namespace MMAP
             return false;
 
         // get this mmap data
-        MMapData* mmap = loadedMMaps[mapId];
+        MMapData* mmap = GetMMapData(mapId);
         ASSERT(mmap->navMesh);
 
         // check if we already have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
-        if (mmap->loadedTileRefs.find(packedGridPos) != mmap->loadedTileRefs.end())
-            return false;
+        auto tileItr = mmap->loadedTileRefs.find(packedGridPos);
+        if (tileItr != mmap->loadedTileRefs.end())
+        {
+            if (!tileItr->second.idle)
+                return false;
+
+            // grid loaded again before its tile was evicted
+            clearTileIdle(mmap, tileItr);
+            ++tileCacheHits;
+            TC_LOG_DEBUG("maps", "MMAP:loadMap: Reused idle mmtile %04i[%02i, %02i]", mapId, x, y);
+            return true;
+        }
+
+        ++tileCacheMisses;
 
         // load this tile :: mmaps/MMMMXXYY.mmtile
-        std::string fileName = Trinity::StringFormat(TILE_FILE_NAME_FORMAT, basePath.c_str(), mapId, x, y);
+        std::string fileName = getTileFileName(basePath, mapId, x, y);
         FILE* file = fopen(fileName.c_str(), "rb");
         if (!file)
         {
             auto parentMapItr = parentMapData.find(mapId);
             if (parentMapItr != parentMapData.end())
             {
-                fileName = Trinity::StringFormat(TILE_FILE_NAME_FORMAT, basePath.c_str(), parentMapItr->second, x, y);
+                fileName = getTileFileName(basePath, parentMapItr->second, x, y);
                 file = fopen(fileName.c_str(), "rb");
             }
         }
@@ -214,9 +259,11 @@ namespace MMAP
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
         if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef)))
         {
-            mmap->loadedTileRefs.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+            mmap->loadedTileRefs.emplace(packedGridPos, MMapTile(tileRef, fileHeader.size));
             ++loadedTiles;
+            tileMemory += fileHeader.size;
             TC_LOG_DEBUG("maps", "MMAP:loadMap: Loaded mmtile %04i[%02i, %02i] into %04i[%02i, %02i]", mapId, x, y, mapId, header->x, header->y);
+            evictIdleTiles(mapId, mmap);
             return true;
         }
         else
@@ -247,14 +294,14 @@ namespace MMAP
         if (!loadMapData(basePath, mapId))
             return false;
 
-        MMapData* mmap = loadedMMaps[mapId];
+        MMapData* mmap = GetMMapData(mapId);
         if (mmap->navMeshQueries.find(instanceId) != mmap->navMeshQueries.end())
             return true;
 
         // allocate mesh query
         dtNavMeshQuery* query = dtAllocNavMeshQuery();
         ASSERT(query);
-        if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
+        if (dtStatusFailed(query->init(mmap->navMesh, NAV_MESH_QUERY_MAX_NODES)))
         {
             dtFreeNavMeshQuery(query);
             TC_LOG_ERROR("maps", "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %04u instanceId %u", mapId, instanceId);
@@ -279,44 +326,130 @@ namespace MMAP
     bool MMapManager::unloadMapImpl(uint32 mapId, int32 x, int32 y)
     {
         // check if we have this map loaded
-        MMapDataSet::const_iterator itr = GetMMapData(mapId);
-        if (itr == loadedMMaps.end())
+        MMapData* mmap = GetMMapData(mapId);
+        if (!mmap)
         {
             // file may not exist, therefore not loaded
             TC_LOG_DEBUG("maps", "MMAP:unloadMap: Asked to unload not loaded navmesh map. %04u%02i%02i.mmtile", mapId, x, y);
             return false;
         }
 
-        MMapData* mmap = itr->second;
-
         // check if we have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
         auto tileRefItr = mmap->loadedTileRefs.find(packedGridPos);
-        if (tileRefItr == mmap->loadedTileRefs.end())
+        if (tileRefItr == mmap->loadedTileRefs.end() || tileRefItr->second.idle)
         {
             // file may not exist, therefore not loaded
             TC_LOG_DEBUG("maps", "MMAP:unloadMap: Asked to unload not loaded navmesh tile. %04u%02i%02i.mmtile", mapId, x, y);
             return false;
         }
 
+        if (tileMemoryLimit)
+        {
+            // keep it in the mesh, loading the grid again will not have to read it
+            setTileIdle(mmap, tileRefItr);
+            TC_LOG_DEBUG("maps", "MMAP:unloadMap: Kept mmtile %04i[%02i, %02i] as idle", mapId, x, y);
+            evictIdleTiles(mapId, mmap);
+            return true;
+        }
+
+        return removeTile(mapId, mmap, tileRefItr);
+    }
+
+    bool MMapManager::removeTile(uint32 mapId, MMapData* mmap, MMapTileSet::iterator tile)
+    {
+        int32 x = int32(tile->first >> 16);
+        int32 y = int32(tile->first & 0x0000FFFF);
+
         // unload, and mark as non loaded
-        if (dtStatusFailed(mmap->navMesh->removeTile(tileRefItr->second, nullptr, nullptr)))
+        if (dtStatusFailed(mmap->navMesh->removeTile(tile->second.ref, nullptr, nullptr)))
         {
             // this is technically a memory leak
             // if the grid is later reloaded, dtNavMesh::addTile will return error but no extra memory is used
             // we cannot recover from this error - assert out
             TC_LOG_ERROR("maps", "MMAP:unloadMap: Could not unload %04u%02i%02i.mmtile from navmesh", mapId, x, y);
             ABORT();
+            return false;
         }
-        else
+
+        if (tile->second.idle)
+            clearTileIdle(mmap, tile);
+
+        tileMemory -= tile->second.dataSize;
+        mmap->loadedTileRefs.erase(tile);
+        --loadedTiles;
+        TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded mmtile %04i[%02i, %02i] from %03i", mapId, x, y, mapId);
+        return true;
+    }
+
+    void MMapManager::setTileIdle(MMapData* mmap, MMapTileSet::iterator tile)
+    {
+        std::lock_guard<std::mutex> lock(idleTileLock);
+        tile->second.idle = true;
+        tile->second.idleStamp = ++nextIdleStamp;
+        mmap->idleTiles.push_front(tile->first);
+        tile->second.idlePosition = mmap->idleTiles.begin();
+        idleTileIndex.emplace(tile->second.idleStamp, tile->second.dataSize);
+    }
+
+    void MMapManager::clearTileIdle(MMapData* mmap, MMapTileSet::iterator tile)
+    {
+        std::lock_guard<std::mutex> lock(idleTileLock);
+        tile->second.idle = false;
+        mmap->idleTiles.erase(tile->second.idlePosition);
+        idleTileIndex.erase(tile->second.idleStamp);
+    }
+
+    uint64 MMapManager::getIdleEvictionStamp()
+    {
+        // the newest idle tile that still has to go for all tiles to fit into the limit, 0 if none has to
+        std::lock_guard<std::mutex> lock(idleTileLock);
+        uint64 memory = tileMemory;
+        uint64 stamp = 0;
+        for (auto itr = idleTileIndex.begin(); itr != idleTileIndex.end() && memory > tileMemoryLimit; ++itr)
         {
-            mmap->loadedTileRefs.erase(tileRefItr);
-            --loadedTiles;
-            TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded mmtile %04i[%02i, %02i] from %03i", mapId, x, y, mapId);
-            return true;
+            memory -= std::min<uint64>(memory, itr->second);
+            stamp = itr->first;
         }
 
-        return false;
+        return stamp;
+    }
+
+    void MMapManager::evictIdleTiles(uint32 mapId, MMapData* mmap)
+    {
+        if (mmap->idleTiles.empty() || tileMemory <= tileMemoryLimit)
+            return;
+
+        // tiles of other maps that are older are evicted by their own map on its next update
+        uint64 evictionStamp = getIdleEvictionStamp();
+        while (!mmap->idleTiles.empty())
+        {
+            MMapTileSet::iterator tile = mmap->loadedTileRefs.find(mmap->idleTiles.back());
+            if (tile->second.idleStamp > evictionStamp)
+                break;
+
+            removeTile(mapId, mmap, tile);
+            ++tileCacheEvictions;
+        }
+    }
+
+    void MMapManager::trimIdleTiles(uint32 mapId)
+    {
+        if (!tileMemoryLimit || tileMemory <= tileMemoryLimit)
+            return;
+
+        auto trim = [this](uint32 id)
+        {
+            if (MMapData* mmap = GetMMapData(id))
+                evictIdleTiles(id, mmap);
+        };
+
+        trim(mapId);
+
+        auto childMaps = childMapData.find(mapId);
+        if (childMaps != childMapData.end())
+            for (uint32 childMapId : childMaps->second)
+                trim(childMapId);
     }
 
     bool MMapManager::unloadMap(uint32 mapId)
@@ -331,31 +464,41 @@ namespace MMAP
 
     bool MMapManager::unloadMapImpl(uint32 mapId)
     {
-        MMapDataSet::iterator itr = loadedMMaps.find(mapId);
-        if (itr == loadedMMaps.end() || !itr->second)
+        MMapData* mmap;
         {
-            // file may not exist, therefore not loaded
-            TC_LOG_DEBUG("maps", "MMAP:unloadMap: Asked to unload not loaded navmesh map %04u", mapId);
-            return false;
+            // other threads stop finding the mesh before it goes away
+            std::unique_lock<std::shared_mutex> lock(loadedMMapsLock);
+            MMapDataSet::iterator itr = loadedMMaps.find(mapId);
+            if (itr == loadedMMaps.end() || !itr->second)
+            {
+                // file may not exist, therefore not loaded
+                TC_LOG_DEBUG("maps", "MMAP:unloadMap: Asked to unload not loaded navmesh map %04u", mapId);
+                return false;
+            }
+
+            mmap = itr->second;
+            itr->second = nullptr;
         }
 
         // unload all tiles from given map
-        MMapData* mmap = itr->second;
         for (MMapTileSet::iterator i = mmap->loadedTileRefs.begin(); i != mmap->loadedTileRefs.end(); ++i)
         {
             uint32 x = (i->first >> 16);
             uint32 y = (i->first & 0x0000FFFF);
-            if (dtStatusFailed(mmap->navMesh->removeTile(i->second, nullptr, nullptr)))
+            if (i->second.idle)
+                clearTileIdle(mmap, i);
+
+            if (dtStatusFailed(mmap->navMesh->removeTile(i->second.ref, nullptr, nullptr)))
                 TC_LOG_ERROR("maps", "MMAP:unloadMap: Could not unload %04u%02i%02i.mmtile from navmesh", mapId, x, y);
             else
             {
                 --loadedTiles;
+                tileMemory -= i->second.dataSize;
                 TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded mmtile %04i[%02i, %02i] from %04i", mapId, x, y, mapId);
             }
         }
 
         delete mmap;
-        itr->second = nullptr;
         TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded %04i.mmap", mapId);
 
         return true;
@@ -364,15 +507,13 @@ namespace MMAP
     bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
     {
         // check if we have this map loaded
-        MMapDataSet::const_iterator itr = GetMMapData(mapId);
-        if (itr == loadedMMaps.end())
+        MMapData* mmap = GetMMapData(mapId);
+        if (!mmap)
         {
             // file may not exist, therefore not loaded
             TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Asked to unload not loaded navmesh map %04u", mapId);
             return false;
         }
-
-        MMapData* mmap = itr->second;
         if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
         {
             TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %04u instanceId %u", mapId, instanceId);
@@ -390,23 +531,55 @@ namespace MMAP
 
     dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
     {
-        MMapDataSet::const_iterator itr = GetMMapData(mapId);
-        if (itr == loadedMMaps.end())
+        MMapData* mmap = GetMMapData(mapId);
+        if (!mmap)
             return nullptr;
 
-        return itr->second->navMesh;
+        return mmap->navMesh;
     }
 
     dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
     {
-        auto itr = GetMMapData(mapId);
-        if (itr == loadedMMaps.end())
+        MMapData* mmap = GetMMapData(mapId);
+        if (!mmap)
             return nullptr;
 
-        auto queryItr = itr->second->navMeshQueries.find(instanceId);
-        if (queryItr == itr->second->navMeshQueries.end())
+        auto queryItr = mmap->navMeshQueries.find(instanceId);
+        if (queryItr == mmap->navMeshQueries.end())
             return nullptr;
 
         return queryItr->second;
     }
+
+    dtNavMeshQuery const* MMapManager::GetThreadNavMeshQuery(uint32 mapId)
+    {
+        // held while the query is bound, so the owning thread cannot delete the mesh meanwhile
+        std::shared_lock<std::shared_mutex> lock(loadedMMapsLock);
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end() || !itr->second)
+            return nullptr;
+
+        MMapData const* mmap = itr->second;
+        ThreadNavMeshQueries::Entry& entry = threadNavMeshQueries.Queries[mapId];
+        if (entry.Query && entry.Serial == mmap->serial)
+            return entry.Query;
+
+        // first use on this thread, or the map was unloaded and loaded again since - never touch the old mesh
+        if (!entry.Query)
+        {
+            entry.Query = dtAllocNavMeshQuery();
+            ASSERT(entry.Query);
+        }
+
+        if (dtStatusFailed(entry.Query->init(mmap->navMesh, NAV_MESH_QUERY_MAX_NODES)))
+        {
+            TC_LOG_ERROR("maps", "MMAP:GetThreadNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %04u", mapId);
+            dtFreeNavMeshQuery(entry.Query);
+            threadNavMeshQueries.Queries.erase(mapId);
+            return nullptr;
+        }
+
+        entry.Serial = mmap->serial;
+        return entry.Query;
+    }
 }
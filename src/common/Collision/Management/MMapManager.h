@@ -22,6 +22,11 @@
 #include "Define.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -29,13 +34,25 @@
 //  move map related classes
 namespace MMAP
 {
-    typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
+    struct MMapTile
+    {
+        MMapTile(dtTileRef ref, uint32 dataSize) : ref(ref), dataSize(dataSize), idle(false), idleStamp(0) { }
+
+        dtTileRef ref;
+        uint32 dataSize;
+        bool idle;                              // grid was unloaded, the tile stays in the mesh until it is evicted
+        std::list<uint32>::iterator idlePosition;   // in MMapData::idleTiles, only valid while idle
+        uint64 idleStamp;                       // when the tile became idle, orders idle tiles of all maps
+    };
+
+    typedef std::unordered_map<uint32, MMapTile> MMapTileSet;
     typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
 
     // dummy struct to hold map's mmap data
     struct TC_COMMON_API MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) { }
+        MMapData(dtNavMesh* mesh, uint32 meshSerial) : navMesh(mesh), serial(meshSerial) { }
+
         ~MMapData()
         {
             for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
@@ -50,6 +67,9 @@ namespace MMAP
 
         dtNavMesh* navMesh;
         MMapTileSet loadedTileRefs;        // maps [map grid coords] to [dtTile]
+        std::list<uint32> idleTiles;        // grid coords of idle tiles, most recently unloaded first
+
+        uint32 const serial;                // unique for every mesh ever loaded, thread queries compare it to notice a reloaded map
     };
 
 
@@ -60,7 +80,8 @@ namespace MMAP
     class TC_COMMON_API MMapManager
     {
         public:
-            MMapManager() : loadedTiles(0), thread_safe_environment(true) {}
+            MMapManager() : loadedTiles(0), thread_safe_environment(true), nextMeshSerial(0), tileMemory(0), tileMemoryLimit(0),
+                tileCacheHits(0), tileCacheMisses(0), tileCacheEvictions(0), nextIdleStamp(0) {}
             ~MMapManager();
 
             void InitializeThreadUnsafe(std::unordered_map<uint32, std::vector<uint32>> const& mapData);
@@ -72,22 +93,62 @@ namespace MMAP
 
             // the returned [dtNavMeshQuery const*] is NOT threadsafe
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // query owned by the calling thread, valid until the next call for the same map from that thread
+            // searches from several threads can run on the same mesh as long as its tiles are not being loaded or unloaded
+            dtNavMeshQuery const* GetThreadNavMeshQuery(uint32 mapId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
+            static std::string getTileFileName(std::string const& basePath, uint32 mapId, int32 x, int32 y);
+
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return uint32(loadedMMaps.size()); }
+
+            // tiles of unloaded grids are kept in the mesh (and reused when the grid is loaded again)
+            // until all tiles together use more than limit bytes, 0 removes them with their grid
+            // idle tiles of all maps are evicted least recently used first, tiles of loaded grids are never evicted
+            void setTileMemoryLimit(uint64 limit) { tileMemoryLimit = limit; }
+            // evicts the idle tiles of mapId (and its child maps) that are among the least recently used of all maps
+            // while all tiles use more than the limit
+            // must be called from the thread owning the mesh, like tile loading and unloading, and from every
+            // map owning a mesh once per update so tiles of other maps go away too
+            void trimIdleTiles(uint32 mapId);
+            uint64 getTileMemory() const { return tileMemory; }
+            uint64 getTileCacheHits() const { return tileCacheHits; }
+            uint64 getTileCacheMisses() const { return tileCacheMisses; }
+            uint64 getTileCacheEvictions() const { return tileCacheEvictions; }
         private:
             bool loadMapData(std::string const& basePath, uint32 mapId);
             bool loadMapImpl(std::string const& basePath, uint32 mapId, int32 x, int32 y);
             bool loadMapInstanceImpl(std::string const& basePath, uint32 mapId, uint32 instanceId);
             bool unloadMapImpl(uint32 mapId, int32 x, int32 y);
             bool unloadMapImpl(uint32 mapId);
+            bool removeTile(uint32 mapId, MMapData* mmap, MMapTileSet::iterator tile);
+            void setTileIdle(MMapData* mmap, MMapTileSet::iterator tile);
+            void clearTileIdle(MMapData* mmap, MMapTileSet::iterator tile);
+            uint64 getIdleEvictionStamp();
+            void evictIdleTiles(uint32 mapId, MMapData* mmap);
             uint32 packTileID(int32 x, int32 y);
 
-            MMapDataSet::const_iterator GetMMapData(uint32 mapId) const;
+            MMapData* GetMMapData(uint32 mapId) const;
+            // every map id is inserted by InitializeThreadUnsafe in the worldserver, so the set never rehashes,
+            // but meshes are created and deleted by the thread owning the map while other threads look them up
             MMapDataSet loadedMMaps;
+            mutable std::shared_mutex loadedMMapsLock;
             uint32 loadedTiles;
             bool thread_safe_environment;
+            std::atomic<uint32> nextMeshSerial;
+
+            std::atomic<uint64> tileMemory;     // data of all tiles in all meshes, idle ones included
+            std::atomic<uint64> tileMemoryLimit;
+            std::atomic<uint64> tileCacheHits;
+            std::atomic<uint64> tileCacheMisses;
+            std::atomic<uint64> tileCacheEvictions;
+
+            // idle tiles of all maps, oldest first: stamp to data size
+            // every map evicts its own tiles, this only decides which of them are old enough
+            std::map<uint64, uint32> idleTileIndex;
+            std::mutex idleTileLock;
+            uint64 nextIdleStamp;
 
             std::unordered_map<uint32, std::vector<uint32>> childMapData;
             std::unordered_map<uint32, uint32> parentMapData;
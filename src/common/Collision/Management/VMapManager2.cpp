@@ -16,6 +16,7 @@
  * with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <string>
@@ -38,6 +39,8 @@ namespace VMAP
         GetLiquidFlagsPtr = &GetLiquidFlagsDummy;
         IsVMAPDisabledForPtr = &IsVMAPDisabledForDummy;
         thread_safe_environment = true;
+        iIdleModelMemory = 0;
+        iIdleModelMemoryLimit = 0;
     }
 
     VMapManager2::~VMapManager2()
@@ -110,6 +113,8 @@ namespace VMAP
             }
             else
                 result = VMAP_LOAD_RESULT_ERROR;
+
+            onTilesChanged();
         }
 
         return result;
@@ -151,6 +156,7 @@ namespace VMAP
                 unloadSingleMap(childMapId, x, y);
 
         unloadSingleMap(mapId, x, y);
+        onTilesChanged();
     }
 
     void VMapManager2::unloadSingleMap(uint32 mapId, int x, int y)
@@ -175,6 +181,7 @@ namespace VMAP
                 unloadSingleMap(childMapId);
 
         unloadSingleMap(mapId);
+        onTilesChanged();
     }
 
     void VMapManager2::unloadSingleMap(uint32 mapId)
@@ -261,6 +268,25 @@ namespace VMAP
         return VMAP_INVALID_HEIGHT_VALUE;
     }
 
+    void VMapManager2::getHeights(unsigned int mapId, float const* x, float const* y, float const* z, float* heights, std::size_t count, float maxSearchDist)
+    {
+        if (isHeightCalcEnabled() && !IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_HEIGHT))
+        {
+            auto instanceTree = GetMapTree(mapId);
+            if (instanceTree != iInstanceMapTrees.end())
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    float height = instanceTree->second->getHeight(convertPositionToInternalRep(x[i], y[i], z[i]), maxSearchDist);
+                    heights[i] = height < G3D::finf() ? height : VMAP_INVALID_HEIGHT_VALUE;
+                }
+                return;
+            }
+        }
+
+        std::fill(heights, heights + count, VMAP_INVALID_HEIGHT_VALUE);
+    }
+
     bool VMapManager2::getAreaInfo(unsigned int mapId, float x, float y, float& z, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const
     {
         if (!IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_AREAFLAG))
@@ -308,28 +334,56 @@ namespace VMAP
 
     WorldModel* VMapManager2::acquireModelInstance(const std::string& basepath, const std::string& filename, uint32 flags/* Only used when creating the model */)
     {
+        auto acquire = [this, &basepath, &filename](ModelFileMap::iterator model)
+        {
+            if (!model->second.getRefCount())
+            {
+                TC_LOG_DEBUG("maps", "VMapManager2: reusing idle file '%s%s'", basepath.c_str(), filename.c_str());
+                iIdleModels.erase(model->second.getIdlePosition());
+                iIdleModelMemory -= model->second.getMemoryUsage();
+            }
+
+            model->second.incRefCount();
+            return model->second.getModel();
+        };
+
+        {
+            //! Critical section, thread safe access to iLoadedModelFiles
+            std::lock_guard<std::mutex> lock(LoadedModelFilesLock);
+
+            auto model = iLoadedModelFiles.find(filename);
+            if (model != iLoadedModelFiles.end())
+                return acquire(model);
+        }
+
+        // parsed outside of the lock, other threads keep loading and releasing models meanwhile
+        WorldModel* worldmodel = new WorldModel();
+        if (!worldmodel->readFile(basepath + filename + ".vmo"))
+        {
+            TC_LOG_ERROR("misc", "VMapManager2: could not load '%s%s.vmo'", basepath.c_str(), filename.c_str());
+            delete worldmodel;
+            return NULL;
+        }
+
+        worldmodel->Flags = flags;
+        std::size_t memoryUsage = worldmodel->GetMemoryUsage();
+
         //! Critical section, thread safe access to iLoadedModelFiles
         std::lock_guard<std::mutex> lock(LoadedModelFilesLock);
 
         auto model = iLoadedModelFiles.find(filename);
         if (model == iLoadedModelFiles.end())
         {
-            WorldModel* worldmodel = new WorldModel();
-            if (!worldmodel->readFile(basepath + filename + ".vmo"))
-            {
-                TC_LOG_ERROR("misc", "VMapManager2: could not load '%s%s.vmo'", basepath.c_str(), filename.c_str());
-                delete worldmodel;
-                return NULL;
-            }
             TC_LOG_DEBUG("maps", "VMapManager2: loading file '%s%s'", basepath.c_str(), filename.c_str());
-            
-            worldmodel->Flags = flags;
-            
             model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel>(filename, ManagedModel())).first;
-            model->second.setModel(worldmodel);
+            model->second.setModel(worldmodel, memoryUsage);
+            model->second.incRefCount();
+            return worldmodel;
         }
-        model->second.incRefCount();
-        return model->second.getModel();
+
+        // another thread loaded the same file meanwhile, keep its model
+        delete worldmodel;
+        return acquire(model);
     }
 
     void VMapManager2::releaseModelInstance(const std::string &filename)
@@ -345,12 +399,45 @@ namespace VMAP
         }
         if (model->second.decRefCount() == 0)
         {
-            TC_LOG_DEBUG("maps", "VMapManager2: unloading file '%s'", filename.c_str());
+            iIdleModels.push_front(filename);
+            model->second.setIdlePosition(iIdleModels.begin());
+            iIdleModelMemory += model->second.getMemoryUsage();
+            trimIdleModels();
+        }
+    }
+
+    void VMapManager2::setIdleModelMemoryLimit(std::size_t limit)
+    {
+        std::lock_guard<std::mutex> lock(LoadedModelFilesLock);
+        iIdleModelMemoryLimit = limit;
+        trimIdleModels();
+    }
+
+    void VMapManager2::trimIdleModels()
+    {
+        while (!iIdleModels.empty() && iIdleModelMemory > iIdleModelMemoryLimit)
+        {
+            auto model = iLoadedModelFiles.find(iIdleModels.back());
+            TC_LOG_DEBUG("maps", "VMapManager2: unloading file '%s'", model->first.c_str());
+            iIdleModelMemory -= model->second.getMemoryUsage();
             delete model->second.getModel();
             iLoadedModelFiles.erase(model);
+            iIdleModels.pop_back();
         }
     }
 
+    void VMapManager2::preloadMapTileModels(const char* basePath, unsigned int mapId, int x, int y, std::vector<std::string>& models)
+    {
+        if (!isMapLoadingEnabled())
+            return;
+
+        StaticMapTree::PreloadTileModels(basePath, mapId, x, y, this, models);
+        auto childMaps = iChildMapData.find(mapId);
+        if (childMaps != iChildMapData.end())
+            for (uint32 childMapId : childMaps->second)
+                StaticMapTree::PreloadTileModels(basePath, childMapId, x, y, this, models);
+    }
+
     LoadResult VMapManager2::existsMap(const char* basePath, unsigned int mapId, int x, int y)
     {
         return StaticMapTree::CanLoadMap(std::string(basePath), mapId, x, y, this);
@@ -19,6 +19,7 @@
 #ifndef _VMAPMANAGER2_H
 #define _VMAPMANAGER2_H
 
+#include <list>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
@@ -54,14 +55,20 @@ namespace VMAP
     class TC_COMMON_API ManagedModel
     {
         public:
-            ManagedModel() : iModel(nullptr), iRefCount(0) { }
-            void setModel(WorldModel* model) { iModel = model; }
+            ManagedModel() : iModel(nullptr), iRefCount(0), iMemoryUsage(0) { }
+            void setModel(WorldModel* model, std::size_t memoryUsage) { iModel = model; iMemoryUsage = memoryUsage; }
             WorldModel* getModel() { return iModel; }
             void incRefCount() { ++iRefCount; }
             int decRefCount() { return --iRefCount; }
+            int getRefCount() const { return iRefCount; }
+            void setIdlePosition(std::list<std::string>::iterator position) { iIdlePosition = position; }
+            std::list<std::string>::iterator getIdlePosition() const { return iIdlePosition; }
+            std::size_t getMemoryUsage() const { return iMemoryUsage; }
         protected:
             WorldModel* iModel;
             int iRefCount;
+            std::size_t iMemoryUsage;
+            std::list<std::string>::iterator iIdlePosition;  // only valid while iRefCount is 0
     };
 
     typedef std::unordered_map<uint32, StaticMapTree*> InstanceTreeMap;
@@ -84,9 +91,16 @@ namespace VMAP
             std::unordered_map<uint32, std::vector<uint32>> iChildMapData;
             std::unordered_map<uint32, uint32> iParentMapData;
             bool thread_safe_environment;
-            // Mutex for iLoadedModelFiles
+            // Models nobody references anymore, most recently released first
+            // They stay loaded until they use more than iIdleModelMemoryLimit bytes together, grids loaded again soon (or other instances of the map) reuse them
+            std::list<std::string> iIdleModels;
+            std::size_t iIdleModelMemory;
+            std::size_t iIdleModelMemoryLimit;
+            // Mutex for iLoadedModelFiles and iIdleModels
             std::mutex LoadedModelFilesLock;
 
+            void trimIdleModels();
+
             static uint32 GetLiquidFlagsDummy(uint32) { return 0; }
             static bool IsVMAPDisabledForDummy(uint32 /*entry*/, uint8 /*flags*/) { return false; }
 
@@ -117,6 +131,7 @@ namespace VMAP
             */
             bool getObjectHitPos(unsigned int mapId, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist) override;
             float getHeight(unsigned int mapId, float x, float y, float z, float maxSearchDist) override;
+            void getHeights(unsigned int mapId, float const* x, float const* y, float const* z, float* heights, std::size_t count, float maxSearchDist) override;
 
             bool processCommand(char* /*command*/) override { return false; } // for debug and extensions
 
@@ -126,6 +141,15 @@ namespace VMAP
             WorldModel* acquireModelInstance(const std::string& basepath, const std::string& filename, uint32 flags = 0);
             void releaseModelInstance(const std::string& filename);
 
+            // memory (in bytes) unreferenced models may keep using, 0 unloads models as soon as they are released
+            void setIdleModelMemoryLimit(std::size_t limit);
+
+            /**
+            Load the models spawned on a tile (and its child maps) ahead of loadMap, safe to call from any thread.
+            Names of the acquired models are appended to models and must be given back to releaseModelInstance.
+            */
+            void preloadMapTileModels(const char* basePath, unsigned int mapId, int x, int y, std::vector<std::string>& models);
+
             // what's the use of this? o.O
             virtual std::string getDirFileName(unsigned int mapId, int /*x*/, int /*y*/) const override
             {
@@ -136,6 +160,7 @@ namespace VMAP
             void getInstanceMapTree(InstanceTreeMap &instanceMapTree);
 
             int32 getParentMapId(uint32 mapId) const;
+            std::unordered_map<uint32, std::vector<uint32>> const& getChildMapData() const { return iChildMapData; }
 
             typedef uint32(*GetLiquidFlagsFn)(uint32 liquidType);
             GetLiquidFlagsFn GetLiquidFlagsPtr;
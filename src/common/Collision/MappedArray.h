@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MAPPEDARRAY_H
+#define _MAPPEDARRAY_H
+
+#include "Define.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/*! Read only array that either owns its elements (geometry built by the tools)
+    or points into a memory mapped file kept alive by its owner (models loaded from disk).
+    Copies always own their elements, only moves keep pointing into the mapping. */
+template<class T>
+class MappedArray
+{
+    public:
+        MappedArray() : _data(nullptr), _size(0) { }
+        MappedArray(MappedArray const& other) : _storage(other.begin(), other.end()) { _data = _storage.empty() ? nullptr : _storage.data(); _size = _storage.size(); }
+        MappedArray(MappedArray&& other) : _storage(std::move(other._storage)), _data(other._data), _size(other._size) { other._data = nullptr; other._size = 0; }
+
+        MappedArray& operator=(MappedArray const& other)
+        {
+            if (this != &other)
+                assign(std::vector<T>(other.begin(), other.end()));
+            return *this;
+        }
+
+        MappedArray& operator=(MappedArray&& other)
+        {
+            if (this != &other)
+            {
+                _storage = std::move(other._storage);
+                _data = other._data;
+                _size = other._size;
+                other._data = nullptr;
+                other._size = 0;
+            }
+            return *this;
+        }
+
+        //! take ownership of the elements
+        void assign(std::vector<T>&& values)
+        {
+            _storage = std::move(values);
+            _data = _storage.empty() ? nullptr : _storage.data();
+            _size = _storage.size();
+        }
+
+        //! point to elements owned by somebody else, they must stay valid as long as this array is used
+        void map(T const* data, std::size_t size)
+        {
+            std::vector<T>().swap(_storage);
+            _data = size ? data : nullptr;
+            _size = size;
+        }
+
+        void clear() { map(nullptr, 0); }
+
+        T const& operator[](std::size_t index) const { return _data[index]; }
+        T const* data() const { return _data; }
+        T const* begin() const { return _data; }
+        T const* end() const { return _data + _size; }
+        std::size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        //! heap memory held by the array, mapped elements belong to the page cache
+        std::size_t GetMemoryUsage() const { return _storage.capacity() * sizeof(T); }
+
+    private:
+        std::vector<T> _storage;
+        T const* _data;
+        std::size_t _size;
+};
+
+/*! Reads a memory mapped file front to back, arrays are handed out in place. */
+class MappedFileReader
+{
+    public:
+        MappedFileReader(char const* data, std::size_t size) : _data(data), _size(size), _position(0) { }
+
+        template<class T>
+        bool read(T& value)
+        {
+            if (sizeof(T) > _size - _position)
+                return false;
+
+            memcpy(static_cast<void*>(&value), _data + _position, sizeof(T));
+            _position += sizeof(T);
+            return true;
+        }
+
+        bool readChunk(char const* compare, std::size_t len)
+        {
+            if (len > _size - _position || memcmp(_data + _position, compare, len) != 0)
+                return false;
+
+            _position += len;
+            return true;
+        }
+
+        //! fails for arrays not aligned in the file, the writers pad everything following a byte array
+        template<class T>
+        bool readArray(MappedArray<T>& array, std::size_t count)
+        {
+            if (count > (_size - _position) / sizeof(T))
+                return false;
+
+            char const* source = _data + _position;
+            if (reinterpret_cast<uintptr_t>(source) % alignof(T) != 0)
+                return false;
+
+            array.map(reinterpret_cast<T const*>(source), count);
+            _position += count * sizeof(T);
+            return true;
+        }
+
+        bool skip(std::size_t len)
+        {
+            if (len > _size - _position)
+                return false;
+
+            _position += len;
+            return true;
+        }
+
+    private:
+        char const* _data;
+        std::size_t _size;
+        std::size_t _position;
+};
+
+#endif // _MAPPEDARRAY_H
@@ -426,6 +426,35 @@ namespace VMAP
 
     //=========================================================
 
+    void StaticMapTree::PreloadTileModels(const std::string &vmapPath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm, std::vector<std::string>& models)
+    {
+        std::string basePath = vmapPath;
+        if (basePath.length() > 0 && basePath[basePath.length()-1] != '/' && basePath[basePath.length()-1] != '\\')
+            basePath.push_back('/');
+
+        TileFileOpenResult fileResult = OpenMapTileFile(basePath, mapID, tileX, tileY, vm);
+        if (!fileResult.File)
+            return;
+
+        char chunk[8];
+        uint32 numSpawns = 0;
+        if (readChunk(fileResult.File, chunk, VMAP_MAGIC, 8) && fread(&numSpawns, sizeof(uint32), 1, fileResult.File) == 1)
+        {
+            for (uint32 i = 0; i < numSpawns; ++i)
+            {
+                ModelSpawn spawn;
+                if (!ModelSpawn::readFromFile(fileResult.File, spawn))
+                    break;
+
+                // same flags LoadMapTile passes, the model is created here and only referenced by the tile later
+                if (vm->acquireModelInstance(basePath, spawn.name, spawn.flags))
+                    models.push_back(spawn.name);
+            }
+        }
+
+        fclose(fileResult.File);
+    }
+
     void StaticMapTree::UnloadMapTile(uint32 tileX, uint32 tileY, VMapManager2* vm)
     {
         uint32 tileID = packTileID(tileX, tileY);
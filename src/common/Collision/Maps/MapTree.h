@@ -74,6 +74,7 @@ namespace VMAP
             static uint32 packTileID(uint32 tileX, uint32 tileY) { return tileX<<16 | tileY; }
             static void unpackTileID(uint32 ID, uint32 &tileX, uint32 &tileY) { tileX = ID >> 16; tileY = ID & 0xFF; }
             static LoadResult CanLoadMap(const std::string &basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm);
+            static void PreloadTileModels(const std::string &basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm, std::vector<std::string>& models);
 
             StaticMapTree(uint32 mapID, const std::string &basePath);
             ~StaticMapTree();
@@ -19,12 +19,18 @@
 #include "TileAssembler.h"
 #include "BoundingIntervalHierarchy.h"
 #include "MapTree.h"
+#include "SHA1.h"
 #include "StringFormat.h"
 #include "VMapDefinitions.h"
 #include <boost/filesystem.hpp>
+#include <atomic>
+#include <fstream>
 #include <iomanip>
+#include <mutex>
 #include <set>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 
 using G3D::Vector3;
 using G3D::AABox;
@@ -53,8 +59,8 @@ namespace VMAP
 
     //=================================================================
 
-    TileAssembler::TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName)
-        : iDestDir(pDestDirName), iSrcDir(pSrcDirName)
+    TileAssembler::TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName, uint32 threads)
+        : iDestDir(pDestDirName), iSrcDir(pSrcDirName), iThreads(std::max(threads, 1u))
     {
         boost::filesystem::create_directory(iDestDir);
     }
@@ -179,18 +185,93 @@ namespace VMAP
         exportGameobjectModels();
         // export objects
         std::cout << "\nConverting Model Files" << std::endl;
-        for (std::set<std::string>::iterator mfile = spawnedModelFiles.begin(); mfile != spawnedModelFiles.end(); ++mfile)
+        if (!convertModelFiles())
+            success = false;
+
+        return success;
+    }
+
+    bool TileAssembler::convertModelFiles()
+    {
+        // the manifest starts with VMAP_MAGIC, followed by one "<raw file hash> <model name>" line per converted model
+        std::string manifestFile = iDestDir + "/" + MODEL_MANIFEST;
+        std::unordered_map<std::string, std::string> previousHashes;
         {
-            std::cout << "Converting " << *mfile << std::endl;
-            if (!convertRawFile(*mfile))
+            std::ifstream manifest(manifestFile);
+            std::string line;
+            if (manifest && std::getline(manifest, line) && line == VMAP_MAGIC)
             {
-                std::cout << "error converting " << *mfile << std::endl;
-                success = false;
-                break;
+                while (std::getline(manifest, line))
+                {
+                    std::size_t separator = line.find(' ');
+                    if (separator != std::string::npos)
+                        previousHashes[line.substr(separator + 1)] = line.substr(0, separator);
+                }
             }
         }
 
-        return success;
+        std::vector<std::string> models(spawnedModelFiles.begin(), spawnedModelFiles.end());
+        std::vector<std::string> hashes(models.size());
+        std::atomic<std::size_t> nextModel(0);
+        std::atomic<uint32> unchangedCount(0);
+        std::atomic<bool> failed(false);
+        std::mutex logLock;
+
+        auto worker = [&]()
+        {
+            for (std::size_t i = nextModel++; i < models.size() && !failed; i = nextModel++)
+            {
+                std::string const& modelName = models[i];
+                std::string hash;
+                {
+                    std::ifstream rawFile(iSrcDir.empty() ? modelName : iSrcDir + "/" + modelName, std::ifstream::binary);
+                    if (rawFile)
+                        hash = CalculateSHA1Hash(std::string(std::istreambuf_iterator<char>(rawFile), std::istreambuf_iterator<char>()));
+                }
+
+                auto previousHash = previousHashes.find(modelName);
+                if (!hash.empty() && previousHash != previousHashes.end() && previousHash->second == hash &&
+                    boost::filesystem::exists(iDestDir + "/" + modelName + ".vmo"))
+                {
+                    hashes[i] = std::move(hash);
+                    ++unchangedCount;
+                    continue;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(logLock);
+                    std::cout << "Converting " << modelName << std::endl;
+                }
+
+                if (!convertRawFile(modelName))
+                {
+                    std::lock_guard<std::mutex> lock(logLock);
+                    std::cout << "error converting " << modelName << std::endl;
+                    failed = true;
+                    break;
+                }
+
+                hashes[i] = std::move(hash);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (uint32 i = 1; i < iThreads && i < models.size(); ++i)
+            threads.emplace_back(worker);
+
+        worker();
+        for (std::thread& thread : threads)
+            thread.join();
+
+        // models converted before a failure are kept so the next run resumes from there
+        std::ofstream manifest(manifestFile, std::ofstream::out | std::ofstream::trunc);
+        manifest << VMAP_MAGIC << '\n';
+        for (std::size_t i = 0; i < models.size(); ++i)
+            if (!hashes[i].empty())
+                manifest << hashes[i] << ' ' << models[i] << '\n';
+
+        std::cout << unchangedCount << " of " << models.size() << " model files were unchanged" << std::endl;
+        return !failed;
     }
 
     bool TileAssembler::readMapSpawns()
@@ -487,17 +568,14 @@ namespace VMAP
             {
                 WMOLiquidHeader hlq;
                 READ_OR_RETURN(&hlq, sizeof(WMOLiquidHeader));
-                liquid = new WmoLiquid(hlq.xtiles, hlq.ytiles, Vector3(hlq.pos_x, hlq.pos_y, hlq.pos_z), liquidType);
-                uint32 size = hlq.xverts * hlq.yverts;
-                READ_OR_RETURN(liquid->GetHeightStorage(), size * sizeof(float));
-                size = hlq.xtiles * hlq.ytiles;
-                READ_OR_RETURN(liquid->GetFlagsStorage(), size);
+                std::vector<float> heights(hlq.xverts * hlq.yverts);
+                READ_OR_RETURN(heights.data(), heights.size() * sizeof(float));
+                std::vector<uint8> flags(hlq.xtiles * hlq.ytiles);
+                READ_OR_RETURN(flags.data(), flags.size());
+                liquid = new WmoLiquid(hlq.xtiles, hlq.ytiles, Vector3(hlq.pos_x, hlq.pos_y, hlq.pos_z), liquidType, std::move(heights), std::move(flags));
             }
             else
-            {
-                liquid = new WmoLiquid(0, 0, Vector3::zero(), liquidType);
-                liquid->GetHeightStorage()[0] = bounds.high().z;
-            }
+                liquid = new WmoLiquid(0, 0, Vector3::zero(), liquidType, std::vector<float>(1, bounds.high().z), std::vector<uint8>());
         }
 
         return true;
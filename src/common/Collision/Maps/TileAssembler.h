@@ -110,9 +110,10 @@ namespace VMAP
             std::string iSrcDir;
             MapData mapData;
             std::set<std::string> spawnedModelFiles;
+            uint32 iThreads;
 
         public:
-            TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName);
+            TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName, uint32 threads = 1);
             virtual ~TileAssembler();
 
             bool convertWorld2();
@@ -121,6 +122,7 @@ namespace VMAP
             void exportGameobjectModels();
 
             bool convertRawFile(const std::string& pModelFilename);
+            bool convertModelFiles();
     };
 
 }                                                           // VMAP
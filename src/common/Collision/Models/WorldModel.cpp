@@ -21,6 +21,8 @@
 #include "MapTree.h"
 #include "ModelInstance.h"
 #include "ModelIgnoreFlags.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 using G3D::Vector3;
 using G3D::Ray;
@@ -32,7 +34,7 @@ template<> struct BoundsTrait<VMAP::GroupModel>
 
 namespace VMAP
 {
-    bool IntersectTriangle(const MeshTriangle &tri, std::vector<Vector3>::const_iterator points, const G3D::Ray &ray, float &distance)
+    bool IntersectTriangle(const MeshTriangle &tri, Vector3 const* points, const G3D::Ray &ray, float &distance)
     {
         static const float EPS = 1e-5f;
 
@@ -85,7 +87,7 @@ namespace VMAP
     class TriBoundFunc
     {
         public:
-            TriBoundFunc(std::vector<Vector3> &vert): vertices(vert.begin()) { }
+            TriBoundFunc(Vector3 const* vert): vertices(vert) { }
             void operator()(const MeshTriangle &tri, G3D::AABox &out) const
             {
                 G3D::Vector3 lo = vertices[tri.idx0];
@@ -97,68 +99,22 @@ namespace VMAP
                 out = G3D::AABox(lo, hi);
             }
         protected:
-            const std::vector<Vector3>::const_iterator vertices;
+            Vector3 const* vertices;
     };
 
     // ===================== WmoLiquid ==================================
 
-    WmoLiquid::WmoLiquid(uint32 width, uint32 height, const Vector3 &corner, uint32 type):
+    WmoLiquid::WmoLiquid(uint32 width, uint32 height, const Vector3 &corner, uint32 type, std::vector<float>&& heights, std::vector<uint8>&& flags):
         iTilesX(width), iTilesY(height), iCorner(corner), iType(type)
     {
-        if (width && height)
-        {
-            iHeight = new float[(width + 1) * (height + 1)];
-            iFlags = new uint8[width * height];
-        }
-        else
-        {
-            iHeight = new float[1];
-            iFlags = nullptr;
-        }
-    }
-
-    WmoLiquid::WmoLiquid(const WmoLiquid &other): iHeight(nullptr), iFlags(nullptr)
-    {
-        *this = other; // use assignment operator...
-    }
-
-    WmoLiquid::~WmoLiquid()
-    {
-        delete[] iHeight;
-        delete[] iFlags;
-    }
-
-    WmoLiquid& WmoLiquid::operator=(const WmoLiquid &other)
-    {
-        if (this == &other)
-            return *this;
-        iTilesX = other.iTilesX;
-        iTilesY = other.iTilesY;
-        iCorner = other.iCorner;
-        iType = other.iType;
-        delete[] iHeight;
-        delete[] iFlags;
-        if (other.iHeight)
-        {
-            iHeight = new float[(iTilesX+1)*(iTilesY+1)];
-            memcpy(iHeight, other.iHeight, (iTilesX+1)*(iTilesY+1)*sizeof(float));
-        }
-        else
-            iHeight = nullptr;
-        if (other.iFlags)
-        {
-            iFlags = new uint8[iTilesX * iTilesY];
-            memcpy(iFlags, other.iFlags, iTilesX * iTilesY);
-        }
-        else
-            iFlags = nullptr;
-        return *this;
+        iHeight.assign(std::move(heights));
+        iFlags.assign(std::move(flags));
     }
 
     bool WmoLiquid::GetLiquidHeight(const Vector3 &pos, float &liqHeight) const
     {
         // simple case
-        if (!iFlags)
+        if (iFlags.empty())
         {
             liqHeight = iHeight[0];
             return true;
@@ -211,12 +167,17 @@ namespace VMAP
         return true;
     }
 
+    std::size_t WmoLiquid::GetMemoryUsage() const
+    {
+        return sizeof(WmoLiquid) + iHeight.GetMemoryUsage() + iFlags.GetMemoryUsage();
+    }
+
     uint32 WmoLiquid::GetFileSize()
     {
         return 2 * sizeof(uint32) +
                 sizeof(Vector3) +
                 sizeof(uint32) +
-                (iFlags ? ((iTilesX + 1) * (iTilesY + 1) * sizeof(float) + iTilesX * iTilesY) : sizeof(float));
+                (iTilesX && iTilesY ? ((iTilesX + 1) * (iTilesY + 1) * sizeof(float) + iTilesX * iTilesY + GetFlagsPadding()) : sizeof(float));
     }
 
     bool WmoLiquid::writeToFile(FILE* wf)
@@ -230,45 +191,39 @@ namespace VMAP
             if (iTilesX && iTilesY)
             {
                 uint32 size = (iTilesX + 1) * (iTilesY + 1);
-                if (fwrite(iHeight, sizeof(float), size, wf) == size)
+                if (fwrite(iHeight.data(), sizeof(float), size, wf) == size)
                 {
                     size = iTilesX * iTilesY;
-                    result = fwrite(iFlags, sizeof(uint8), size, wf) == size;
+                    static uint8 const padding[4] = { };
+                    result = fwrite(iFlags.data(), sizeof(uint8), size, wf) == size &&
+                        fwrite(padding, sizeof(uint8), GetFlagsPadding(), wf) == GetFlagsPadding();
                 }
             }
             else
-                result = fwrite(iHeight, sizeof(float), 1, wf) == 1;
+                result = fwrite(iHeight.data(), sizeof(float), 1, wf) == 1;
         }
 
         return result;
     }
 
-    bool WmoLiquid::readFromFile(FILE* rf, WmoLiquid* &out)
+    bool WmoLiquid::readFromFile(MappedFileReader& reader, WmoLiquid* &out)
     {
         bool result = false;
         WmoLiquid* liquid = new WmoLiquid();
 
-        if (fread(&liquid->iTilesX, sizeof(uint32), 1, rf) == 1 &&
-            fread(&liquid->iTilesY, sizeof(uint32), 1, rf) == 1 &&
-            fread(&liquid->iCorner, sizeof(Vector3), 1, rf) == 1 &&
-            fread(&liquid->iType, sizeof(uint32), 1, rf) == 1)
+        if (reader.read(liquid->iTilesX) &&
+            reader.read(liquid->iTilesY) &&
+            reader.read(liquid->iCorner) &&
+            reader.read(liquid->iType))
         {
             if (liquid->iTilesX && liquid->iTilesY)
             {
-                uint32 size = (liquid->iTilesX + 1) * (liquid->iTilesY + 1);
-                liquid->iHeight = new float[size];
-                if (fread(liquid->iHeight, sizeof(float), size, rf) == size)
-                {
-                    size = liquid->iTilesX * liquid->iTilesY;
-                    liquid->iFlags = new uint8[size];
-                    result = fread(liquid->iFlags, sizeof(uint8), size, rf) == size;
-                }
+                result = reader.readArray(liquid->iHeight, (liquid->iTilesX + 1) * (liquid->iTilesY + 1)) &&
+                    reader.readArray(liquid->iFlags, liquid->iTilesX * liquid->iTilesY) &&
+                    reader.skip(liquid->GetFlagsPadding());
             }
             else
-            {
-                liquid->iHeight = new float[1];
-                result = fread(liquid->iHeight, sizeof(float), 1, rf) == 1;
-            }
+                result = reader.readArray(liquid->iHeight, 1);
         }
 
         if (!result)
@@ -298,9 +253,9 @@ namespace VMAP
 
     void GroupModel::setMeshData(std::vector<Vector3> &vert, std::vector<MeshTriangle> &tri)
     {
-        vertices.swap(vert);
-        triangles.swap(tri);
-        TriBoundFunc bFunc(vertices);
+        vertices.assign(std::move(vert));
+        triangles.assign(std::move(tri));
+        TriBoundFunc bFunc(vertices.data());
         meshTree.build(triangles, bFunc);
     }
 
@@ -321,7 +276,7 @@ namespace VMAP
         if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
         if (!count) // models without (collision) geometry end here, unsure if they are useful
             return result;
-        if (result && fwrite(&vertices[0], sizeof(Vector3), count, wf) != count) result = false;
+        if (result && fwrite(vertices.data(), sizeof(Vector3), count, wf) != count) result = false;
 
         // write triangle mesh
         if (result && fwrite("TRIM", 1, 4, wf) != 4) result = false;
@@ -329,7 +284,7 @@ namespace VMAP
         chunkSize = sizeof(uint32)+ sizeof(MeshTriangle)*count;
         if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
         if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
-        if (result && fwrite(&triangles[0], sizeof(MeshTriangle), count, wf) != count) result = false;
+        if (result && fwrite(triangles.data(), sizeof(MeshTriangle), count, wf) != count) result = false;
 
         // write mesh BIH
         if (result && fwrite("MBIH", 1, 4, wf) != 4) result = false;
@@ -350,9 +305,8 @@ namespace VMAP
         return result;
     }
 
-    bool GroupModel::readFromFile(FILE* rf)
+    bool GroupModel::readFromFile(MappedFileReader& reader)
     {
-        char chunk[8];
         bool result = true;
         uint32 chunkSize = 0;
         uint32 count = 0;
@@ -361,50 +315,48 @@ namespace VMAP
         delete iLiquid;
         iLiquid = NULL;
 
-        if (result && fread(&iBound, sizeof(G3D::AABox), 1, rf) != 1) result = false;
-        if (result && fread(&iMogpFlags, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&iGroupWMOID, sizeof(uint32), 1, rf) != 1) result = false;
+        if (result && !reader.read(iBound)) result = false;
+        if (result && !reader.read(iMogpFlags)) result = false;
+        if (result && !reader.read(iGroupWMOID)) result = false;
 
         // read vertices
-        if (result && !readChunk(rf, chunk, "VERT", 4)) result = false;
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
+        if (result && !reader.readChunk("VERT", 4)) result = false;
+        if (result && !reader.read(chunkSize)) result = false;
+        if (result && !reader.read(count)) result = false;
         if (!count) // models without (collision) geometry end here, unsure if they are useful
             return result;
-        if (result) vertices.resize(count);
-        if (result && fread(&vertices[0], sizeof(Vector3), count, rf) != count) result = false;
+        if (result && !reader.readArray(vertices, count)) result = false;
 
         // read triangle mesh
-        if (result && !readChunk(rf, chunk, "TRIM", 4)) result = false;
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result) triangles.resize(count);
-        if (result && fread(&triangles[0], sizeof(MeshTriangle), count, rf) != count) result = false;
+        if (result && !reader.readChunk("TRIM", 4)) result = false;
+        if (result && !reader.read(chunkSize)) result = false;
+        if (result && !reader.read(count)) result = false;
+        if (result && !reader.readArray(triangles, count)) result = false;
 
         // read mesh BIH
-        if (result && !readChunk(rf, chunk, "MBIH", 4)) result = false;
-        if (result) result = meshTree.readFromFile(rf);
+        if (result && !reader.readChunk("MBIH", 4)) result = false;
+        if (result) result = meshTree.readFromFile(reader);
 
         // write liquid data
-        if (result && !readChunk(rf, chunk, "LIQU", 4)) result = false;
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
+        if (result && !reader.readChunk("LIQU", 4)) result = false;
+        if (result && !reader.read(chunkSize)) result = false;
         if (result && chunkSize > 0)
-            result = WmoLiquid::readFromFile(rf, iLiquid);
+            result = WmoLiquid::readFromFile(reader, iLiquid);
         return result;
     }
 
     struct GModelRayCallback
     {
-        GModelRayCallback(const std::vector<MeshTriangle> &tris, const std::vector<Vector3> &vert):
-            vertices(vert.begin()), triangles(tris.begin()), hit(false) { }
+        GModelRayCallback(MappedArray<MeshTriangle> const& tris, MappedArray<Vector3> const& vert):
+            vertices(vert.data()), triangles(tris.data()), hit(false) { }
         bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool /*pStopAtFirstHit*/)
         {
             bool result = IntersectTriangle(triangles[entry], vertices, ray, distance);
             if (result)  hit=true;
             return hit;
         }
-        std::vector<Vector3>::const_iterator vertices;
-        std::vector<MeshTriangle>::const_iterator triangles;
+        Vector3 const* vertices;
+        MeshTriangle const* triangles;
         bool hit;
     };
 
@@ -448,13 +400,26 @@ namespace VMAP
 
     void GroupModel::getMeshData(std::vector<G3D::Vector3>& outVertices, std::vector<MeshTriangle>& outTriangles, WmoLiquid*& liquid)
     {
-        outVertices = vertices;
-        outTriangles = triangles;
+        outVertices.assign(vertices.begin(), vertices.end());
+        outTriangles.assign(triangles.begin(), triangles.end());
         liquid = iLiquid;
     }
 
+    std::size_t GroupModel::GetMemoryUsage() const
+    {
+        std::size_t size = vertices.GetMemoryUsage() + triangles.GetMemoryUsage() + meshTree.GetMemoryUsage();
+        if (iLiquid)
+            size += iLiquid->GetMemoryUsage();
+
+        return size;
+    }
+
     // ===================== WorldModel ==================================
 
+    WorldModel::WorldModel(): RootWMOID(0) { }
+
+    WorldModel::~WorldModel() { }
+
     void WorldModel::setGroupModels(std::vector<GroupModel> &models)
     {
         groupModels.swap(models);
@@ -601,37 +566,41 @@ namespace VMAP
 
     bool WorldModel::readFile(const std::string &filename)
     {
-        FILE* rf = fopen(filename.c_str(), "rb");
-        if (!rf)
+        try
+        {
+            // the mapping stays valid after the file handle is closed at the end of this scope
+            boost::interprocess::file_mapping file(filename.c_str(), boost::interprocess::read_only);
+            iMappedFile.reset(new boost::interprocess::mapped_region(file, boost::interprocess::read_only));
+        }
+        catch (boost::interprocess::interprocess_exception const&)
+        {
+            // missing or empty file
             return false;
+        }
 
+        MappedFileReader reader(static_cast<char const*>(iMappedFile->get_address()), iMappedFile->get_size());
         bool result = true;
         uint32 chunkSize = 0;
         uint32 count = 0;
-        char chunk[8];                          // Ignore the added magic header
-        if (!readChunk(rf, chunk, VMAP_MAGIC, 8)) result = false;
+        if (!reader.readChunk(VMAP_MAGIC, 8)) result = false;
 
-        if (result && !readChunk(rf, chunk, "WMOD", 4)) result = false;
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&RootWMOID, sizeof(uint32), 1, rf) != 1) result = false;
+        if (result && !reader.readChunk("WMOD", 4)) result = false;
+        if (result && !reader.read(chunkSize)) result = false;
+        if (result && !reader.read(RootWMOID)) result = false;
 
         // read group models
-        if (result && readChunk(rf, chunk, "GMOD", 4))
+        if (result && reader.readChunk("GMOD", 4))
         {
-            //if (fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
-
-            if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
+            if (result && !reader.read(count)) result = false;
             if (result) groupModels.resize(count);
-            //if (result && fread(&groupModels[0], sizeof(GroupModel), count, rf) != count) result = false;
             for (uint32 i=0; i<count && result; ++i)
-                result = groupModels[i].readFromFile(rf);
+                result = groupModels[i].readFromFile(reader);
 
             // read group BIH
-            if (result && !readChunk(rf, chunk, "GBIH", 4)) result = false;
-            if (result) result = groupTree.readFromFile(rf);
+            if (result && !reader.readChunk("GBIH", 4)) result = false;
+            if (result) result = groupTree.readFromFile(reader);
         }
 
-        fclose(rf);
         return result;
     }
 
@@ -639,4 +608,13 @@ namespace VMAP
     {
         outGroupModels = groupModels;
     }
+
+    std::size_t WorldModel::GetMemoryUsage() const
+    {
+        std::size_t size = sizeof(WorldModel) + groupModels.capacity() * sizeof(GroupModel) + groupTree.GetMemoryUsage();
+        for (GroupModel const& group : groupModels)
+            size += group.GetMemoryUsage();
+
+        return size;
+    }
 }
@@ -24,8 +24,12 @@
 #include <G3D/AABox.h>
 #include <G3D/Ray.h>
 #include "BoundingIntervalHierarchy.h"
+#include "MappedArray.h"
 
 #include "Define.h"
+#include <memory>
+
+namespace boost { namespace interprocess { class mapped_region; } }
 
 namespace VMAP
 {
@@ -48,26 +52,27 @@ namespace VMAP
     class TC_COMMON_API WmoLiquid
     {
         public:
-            WmoLiquid(uint32 width, uint32 height, const G3D::Vector3 &corner, uint32 type);
-            WmoLiquid(const WmoLiquid &other);
-            ~WmoLiquid();
-            WmoLiquid& operator=(const WmoLiquid &other);
+            //! heights holds (width + 1)*(height + 1) values and flags width*height, or a single height and no flags for flat liquids
+            WmoLiquid(uint32 width, uint32 height, const G3D::Vector3 &corner, uint32 type, std::vector<float>&& heights, std::vector<uint8>&& flags);
             bool GetLiquidHeight(const G3D::Vector3 &pos, float &liqHeight) const;
             uint32 GetType() const { return iType; }
-            float *GetHeightStorage() { return iHeight; }
-            uint8 *GetFlagsStorage() { return iFlags; }
+            float const* GetHeightStorage() const { return iHeight.data(); }
+            uint8 const* GetFlagsStorage() const { return iFlags.data(); }
             uint32 GetFileSize();
+            std::size_t GetMemoryUsage() const;
             bool writeToFile(FILE* wf);
-            static bool readFromFile(FILE* rf, WmoLiquid* &liquid);
+            static bool readFromFile(MappedFileReader& reader, WmoLiquid* &liquid);
             void getPosInfo(uint32 &tilesX, uint32 &tilesY, G3D::Vector3 &corner) const;
         private:
-            WmoLiquid() : iTilesX(0), iTilesY(0), iCorner(), iType(0), iHeight(NULL), iFlags(NULL) { }
+            WmoLiquid() : iTilesX(0), iTilesY(0), iCorner(), iType(0) { }
+            //! zero bytes written after the flags to keep the following arrays aligned for mapping
+            uint32 GetFlagsPadding() const { return (4 - iFlags.size() % 4) % 4; }
             uint32 iTilesX;       //!< number of tiles in x direction, each
             uint32 iTilesY;
             G3D::Vector3 iCorner; //!< the lower corner
             uint32 iType;         //!< liquid type
-            float *iHeight;       //!< (tilesX + 1)*(tilesY + 1) height values
-            uint8 *iFlags;        //!< info if liquid tile is used
+            MappedArray<float> iHeight; //!< (tilesX + 1)*(tilesY + 1) height values
+            MappedArray<uint8> iFlags;  //!< info if liquid tile is used
     };
 
     /*! holding additional info for WMO group files */
@@ -80,7 +85,7 @@ namespace VMAP
                         iBound(bound), iMogpFlags(mogpFlags), iGroupWMOID(groupWMOID), iLiquid(NULL) { }
             ~GroupModel() { delete iLiquid; }
 
-            //! pass mesh data to object and create BIH. Passed vectors get get swapped with old geometry!
+            //! pass mesh data to object and create BIH. Passed vectors are moved into the model!
             void setMeshData(std::vector<G3D::Vector3> &vert, std::vector<MeshTriangle> &tri);
             void setLiquidData(WmoLiquid*& liquid) { iLiquid = liquid; liquid = NULL; }
             bool IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit) const;
@@ -88,17 +93,18 @@ namespace VMAP
             bool GetLiquidLevel(const G3D::Vector3 &pos, float &liqHeight) const;
             uint32 GetLiquidType() const;
             bool writeToFile(FILE* wf);
-            bool readFromFile(FILE* rf);
+            bool readFromFile(MappedFileReader& reader);
             const G3D::AABox& GetBound() const { return iBound; }
             uint32 GetMogpFlags() const { return iMogpFlags; }
             uint32 GetWmoID() const { return iGroupWMOID; }
+            std::size_t GetMemoryUsage() const;
             void getMeshData(std::vector<G3D::Vector3>& outVertices, std::vector<MeshTriangle>& outTriangles, WmoLiquid*& liquid);
         protected:
             G3D::AABox iBound;
             uint32 iMogpFlags;// 0x8 outdor; 0x2000 indoor
             uint32 iGroupWMOID;
-            std::vector<G3D::Vector3> vertices;
-            std::vector<MeshTriangle> triangles;
+            MappedArray<G3D::Vector3> vertices;
+            MappedArray<MeshTriangle> triangles;
             BIH meshTree;
             WmoLiquid* iLiquid;
     };
@@ -107,7 +113,8 @@ namespace VMAP
     class TC_COMMON_API WorldModel
     {
         public:
-            WorldModel(): RootWMOID(0) { }
+            WorldModel();
+            ~WorldModel();
 
             //! pass group models to WorldModel and create BIH. Passed vector is swapped with old geometry!
             void setGroupModels(std::vector<GroupModel> &models);
@@ -116,10 +123,14 @@ namespace VMAP
             bool IntersectPoint(const G3D::Vector3 &p, const G3D::Vector3 &down, float &dist, AreaInfo &info) const;
             bool GetLocationInfo(const G3D::Vector3 &p, const G3D::Vector3 &down, float &dist, LocationInfo &info) const;
             bool writeFile(const std::string &filename);
+            //! maps the file, vertices, triangles, trees and liquids of the groups point into the mapping
             bool readFile(const std::string &filename);
             void getGroupModels(std::vector<GroupModel>& outGroupModels);
+            //! heap memory held by the model, for cache budgets. Mapped data is not counted, the OS pages it in and out
+            std::size_t GetMemoryUsage() const;
             uint32 Flags;
         protected:
+            std::unique_ptr<boost::interprocess::mapped_region> iMappedFile;
             uint32 RootWMOID;
             std::vector<GroupModel> groupModels;
             BIH groupTree;
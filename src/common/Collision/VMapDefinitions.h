@@ -25,9 +25,10 @@
 
 namespace VMAP
 {
-    const char VMAP_MAGIC[] = "VMAP_4.8";
+    const char VMAP_MAGIC[] = "VMAP_4.9";
     const char RAW_VMAP_MAGIC[] = "VMAP048";                // used in extracted vmap files with raw data
     const char GAMEOBJECT_MODELS[] = "GameObjectModels.dtree";
+    const char MODEL_MANIFEST[] = "ModelManifest.txt";       // hashes of the raw files the .vmo files were built from
 
     // defined in TileAssembler.cpp currently...
     bool readChunk(FILE* rf, char *dest, const char *compare, uint32 len);
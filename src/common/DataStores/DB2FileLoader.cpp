@@ -150,6 +150,11 @@ DB2FileSource::~DB2FileSource()
 {
 }
 
+unsigned char const* DB2FileSource::ReadInPlace(std::size_t /*numBytes*/)
+{
+    return nullptr;
+}
+
 class DB2FileLoaderImpl
 {
 public:
@@ -162,12 +167,14 @@ public:
         std::unique_ptr<DB2IndexData[]> parentIndexes) = 0;
     virtual char* AutoProduceData(uint32& count, char**& indexTable, std::vector<char*>& stringPool) = 0;
     virtual char* AutoProduceStrings(char** indexTable, uint32 indexTableSize, uint32 locale) = 0;
+    virtual bool AutoProduceStringsInPlace(char** indexTable, uint32 indexTableSize, uint32 locale) = 0;
     virtual void AutoProduceRecordCopies(uint32 records, char** indexTable, char* dataTable) = 0;
     virtual DB2Record GetRecord(uint32 recordNumber) const = 0;
     virtual DB2RecordCopy GetRecordCopy(uint32 copyNumber) const = 0;
     virtual uint32 GetRecordCount() const = 0;
     virtual uint32 GetRecordCopyCount() const = 0;
     virtual uint32 GetMaxId() const = 0;
+    virtual bool IsLoadedInPlace() const = 0;
     virtual DB2FileLoadInfo const* GetLoadInfo() const = 0;
 
 private:
@@ -199,16 +206,20 @@ public:
         std::unique_ptr<DB2IndexData[]> parentIndexes) override;
     char* AutoProduceData(uint32& count, char**& indexTable, std::vector<char*>& stringPool) override;
     char* AutoProduceStrings(char** indexTable, uint32 indexTableSize, uint32 locale) override;
+    bool AutoProduceStringsInPlace(char** indexTable, uint32 indexTableSize, uint32 locale) override;
     void AutoProduceRecordCopies(uint32 records, char** indexTable, char* dataTable) override;
     DB2Record GetRecord(uint32 recordNumber) const override;
     DB2RecordCopy GetRecordCopy(uint32 copyNumber) const override;
     uint32 GetRecordCount() const override;
     uint32 GetRecordCopyCount() const override;
     uint32 GetMaxId() const override;
+    bool IsLoadedInPlace() const override { return !_dataCopy; }
     DB2FileLoadInfo const* GetLoadInfo() const override;
 
 private:
     void FillParentLookup(char* dataTable);
+    bool CheckLocale(uint32 locale) const;
+    void FillStrings(char** indexTable, uint32 indexTableSize, uint32 locale, char const* strings);
     uint8 const* GetRawRecordData(uint32 recordNumber) const override;
     uint32 RecordGetId(uint8 const* record, uint32 recordIndex) const override;
     uint8 RecordGetUInt8(uint8 const* record, uint32 field, uint32 arrayIndex) const override;
@@ -228,8 +239,9 @@ private:
     char const* _fileName;
     DB2FileLoadInfo const* _loadInfo;
     DB2Header const* _header;
-    std::unique_ptr<uint8[]> _data;
-    uint8* _stringTable;
+    uint8 const* _data;
+    std::unique_ptr<uint8[]> _dataCopy;                    // only used when the source can not be read in place
+    uint8 const* _stringTable;
     std::unique_ptr<uint32[]> _idTable;
     std::unique_ptr<DB2RecordCopy[]> _copyTable;
     std::unique_ptr<DB2ColumnMeta[]> _columnMeta;
@@ -253,12 +265,14 @@ public:
         std::unique_ptr<DB2IndexData[]> parentIndexes) override;
     char* AutoProduceData(uint32& records, char**& indexTable, std::vector<char*>& stringPool) override;
     char* AutoProduceStrings(char** indexTable, uint32 indexTableSize, uint32 locale) override;
+    bool AutoProduceStringsInPlace(char** /*indexTable*/, uint32 /*indexTableSize*/, uint32 /*locale*/) override { return false; }
     void AutoProduceRecordCopies(uint32 /*records*/, char** /*indexTable*/, char* /*dataTable*/) override { }
     DB2Record GetRecord(uint32 recordNumber) const override;
     DB2RecordCopy GetRecordCopy(uint32 copyNumber) const override;
     uint32 GetRecordCount() const override;
     uint32 GetRecordCopyCount() const override;
     uint32 GetMaxId() const override;
+    bool IsLoadedInPlace() const override { return false; }
     DB2FileLoadInfo const* GetLoadInfo() const override;
 
 private:
@@ -295,15 +309,26 @@ DB2FileLoaderRegularImpl::DB2FileLoaderRegularImpl(char const* fileName, DB2File
     _fileName(fileName),
     _loadInfo(loadInfo),
     _header(header),
+    _data(nullptr),
     _stringTable(nullptr)
 {
 }
 
 bool DB2FileLoaderRegularImpl::LoadTableData(DB2FileSource* source)
 {
-    _data = Trinity::make_unique<uint8[]>(_header->RecordSize * _header->RecordCount + _header->StringTableSize);
+    std::size_t size = _header->RecordSize * _header->RecordCount + _header->StringTableSize;
+    _data = source->ReadInPlace(size);
+    if (!_data)
+    {
+        _dataCopy = Trinity::make_unique<uint8[]>(size);
+        if (!source->Read(_dataCopy.get(), size))
+            return false;
+
+        _data = _dataCopy.get();
+    }
+
     _stringTable = &_data[_header->RecordSize * _header->RecordCount];
-    return source->Read(_data.get(), _header->RecordSize * _header->RecordCount + _header->StringTableSize);
+    return true;
 }
 
 void DB2FileLoaderRegularImpl::SetAdditionalData(std::unique_ptr<DB2FieldEntry[]> /*fields*/, std::unique_ptr<uint32[]> idTable, std::unique_ptr<DB2RecordCopy[]> copyTable,
@@ -486,6 +511,27 @@ char* DB2FileLoaderRegularImpl::AutoProduceData(uint32& records, char**& indexTa
 }
 
 char* DB2FileLoaderRegularImpl::AutoProduceStrings(char** indexTable, uint32 indexTableSize, uint32 locale)
+{
+    if (!CheckLocale(locale))
+        return nullptr;
+
+    char* stringPool = new char[_header->StringTableSize];
+    memcpy(stringPool, _stringTable, _header->StringTableSize);
+    FillStrings(indexTable, indexTableSize, locale, stringPool);
+    return stringPool;
+}
+
+bool DB2FileLoaderRegularImpl::AutoProduceStringsInPlace(char** indexTable, uint32 indexTableSize, uint32 locale)
+{
+    if (!IsLoadedInPlace() || !CheckLocale(locale))
+        return false;
+
+    // string table of the file is used as is, its pages are only read when a string is accessed
+    FillStrings(indexTable, indexTableSize, locale, reinterpret_cast<char const*>(_stringTable));
+    return true;
+}
+
+bool DB2FileLoaderRegularImpl::CheckLocale(uint32 locale) const
 {
     if (!(_header->Locale & (1 << locale)))
     {
@@ -501,12 +547,14 @@ char* DB2FileLoaderRegularImpl::AutoProduceStrings(char** indexTable, uint32 ind
         }
 
         TC_LOG_ERROR("", "Attempted to load %s which has locales %s as %s. Check if you placed your localized db2 files in correct directory.", _fileName, str.str().c_str(), localeNames[locale]);
-        return nullptr;
+        return false;
     }
 
-    char* stringPool = new char[_header->StringTableSize];
-    memcpy(stringPool, _stringTable, _header->StringTableSize);
+    return true;
+}
 
+void DB2FileLoaderRegularImpl::FillStrings(char** indexTable, uint32 indexTableSize, uint32 locale, char const* strings)
+{
     for (uint32 y = 0; y < _header->RecordCount; y++)
     {
         unsigned char const* rawRecord = GetRawRecordData(y);
@@ -553,7 +601,7 @@ char* DB2FileLoaderRegularImpl::AutoProduceStrings(char** indexTable, uint32 ind
                         if (db2str->Str[locale] == nullStr)
                         {
                             char const* st = RecordGetString(rawRecord, x, z);
-                            db2str->Str[locale] = stringPool + (st - (char const*)_stringTable);
+                            db2str->Str[locale] = strings + (st - (char const*)_stringTable);
                         }
 
                         offset += sizeof(char*);
@@ -561,9 +609,9 @@ char* DB2FileLoaderRegularImpl::AutoProduceStrings(char** indexTable, uint32 ind
                     }
                     case FT_STRING_NOT_LOCALIZED:
                     {
-                        char** db2str = (char**)(&recordData[offset]);
+                        char const** db2str = (char const**)(&recordData[offset]);
                         char const* st = RecordGetString(rawRecord, x, z);
-                        *db2str = stringPool + (st - (char const*)_stringTable);
+                        *db2str = strings + (st - (char const*)_stringTable);
                         offset += sizeof(char*);
                         break;
                     }
@@ -575,8 +623,6 @@ char* DB2FileLoaderRegularImpl::AutoProduceStrings(char** indexTable, uint32 ind
             }
         }
     }
-
-    return stringPool;
 }
 
 void DB2FileLoaderRegularImpl::AutoProduceRecordCopies(uint32 records, char** indexTable, char* dataTable)
@@ -697,7 +743,7 @@ char const* DB2FileLoaderRegularImpl::RecordGetString(uint8 const* record, uint3
 {
     uint32 stringOffset = RecordGetVarInt<uint32>(record, field, arrayIndex);
     ASSERT(stringOffset < _header->StringTableSize);
-    return reinterpret_cast<char*>(_stringTable + stringOffset);
+    return reinterpret_cast<char const*>(_stringTable + stringOffset);
 }
 
 template<typename T>
@@ -729,7 +775,7 @@ T DB2FileLoaderRegularImpl::RecordGetVarInt(uint8 const* record, uint32 field, u
         }
         case DB2ColumnCompression::CommonData:
         {
-            uint32 id = RecordGetId(record, (_data.get() - record) / _header->RecordSize);
+            uint32 id = RecordGetId(record, (_data - record) / _header->RecordSize);
             T value;
             auto valueItr = _commonValues[field].find(id);
             if (valueItr != _commonValues[field].end())
@@ -1577,6 +1623,11 @@ char* DB2FileLoader::AutoProduceStrings(char** indexTable, uint32 indexTableSize
     return _impl->AutoProduceStrings(indexTable, indexTableSize, locale);
 }
 
+bool DB2FileLoader::AutoProduceStringsInPlace(char** indexTable, uint32 indexTableSize, uint32 locale)
+{
+    return _impl->AutoProduceStringsInPlace(indexTable, indexTableSize, locale);
+}
+
 void DB2FileLoader::AutoProduceRecordCopies(uint32 records, char** indexTable, char* dataTable)
 {
     _impl->AutoProduceRecordCopies(records, indexTable, dataTable);
@@ -1597,6 +1648,11 @@ uint32 DB2FileLoader::GetMaxId() const
     return _impl->GetMaxId();
 }
 
+bool DB2FileLoader::IsLoadedInPlace() const
+{
+    return _impl->IsLoadedInPlace();
+}
+
 DB2Record DB2FileLoader::GetRecord(uint32 recordNumber) const
 {
     return _impl->GetRecord(recordNumber);
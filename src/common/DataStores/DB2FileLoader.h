@@ -79,6 +79,10 @@ struct TC_COMMON_API DB2FileSource
     // Returns true if numBytes was read successfully
     virtual bool Read(void* buffer, std::size_t numBytes) = 0;
 
+    // Returns a pointer to the next numBytes bytes of source and moves past them, the data stays valid as long as the source exists
+    // Returns nullptr if the source can not be read in place (Read must be used instead)
+    virtual unsigned char const* ReadInPlace(std::size_t numBytes);
+
     // Returns current read position in file
     virtual std::size_t GetPosition() const = 0;
 
@@ -141,6 +145,9 @@ public:
     bool Load(DB2FileSource* source, DB2FileLoadInfo const* loadInfo);
     char* AutoProduceData(uint32& count, char**& indexTable, std::vector<char*>& stringPool);
     char* AutoProduceStrings(char** indexTable, uint32 indexTableSize, uint32 locale);
+    // Same as AutoProduceStrings but strings point directly into the source, which must then outlive the records
+    // Only possible if IsLoadedInPlace()
+    bool AutoProduceStringsInPlace(char** indexTable, uint32 indexTableSize, uint32 locale);
     void AutoProduceRecordCopies(uint32 records, char** indexTable, char* dataTable);
 
     uint32 GetCols() const { return _header.TotalFieldCount; }
@@ -150,6 +157,9 @@ public:
     uint32 GetLayoutHash() const { return _header.LayoutHash; }
     uint32 GetMaxId() const;
 
+    // true if record data was not copied out of the source (the source must be kept until the loader is done)
+    bool IsLoadedInPlace() const;
+
     DB2Record GetRecord(uint32 recordNumber) const;
     DB2RecordCopy GetRecordCopy(uint32 copyNumber) const;
 
@@ -16,40 +16,60 @@
  */
 
 #include "DB2FileSystemSource.h"
-#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstring>
 
-DB2FileSystemSource::DB2FileSystemSource(std::string const& fileName)
+DB2FileSystemSource::DB2FileSystemSource(std::string const& fileName) : _fileName(fileName), _position(0)
 {
-    _fileName = fileName;
-    _file = fopen(_fileName.c_str(), "rb");
+    try
+    {
+        boost::interprocess::file_mapping file(_fileName.c_str(), boost::interprocess::read_only);
+        _region.reset(new boost::interprocess::mapped_region(file, boost::interprocess::read_only));
+    }
+    catch (boost::interprocess::interprocess_exception const&)
+    {
+        // missing or empty file, reported by IsOpen
+    }
 }
 
 DB2FileSystemSource::~DB2FileSystemSource()
 {
-    if (_file)
-        fclose(_file);
 }
 
 bool DB2FileSystemSource::IsOpen() const
 {
-    return _file != nullptr;
+    return _region != nullptr;
 }
 
 bool DB2FileSystemSource::Read(void* buffer, std::size_t numBytes)
 {
-    return fread(buffer, numBytes, 1, _file) == 1;
+    unsigned char const* data = ReadInPlace(numBytes);
+    if (!data)
+        return false;
+
+    memcpy(buffer, data, numBytes);
+    return true;
+}
+
+unsigned char const* DB2FileSystemSource::ReadInPlace(std::size_t numBytes)
+{
+    if (!_region || numBytes > _region->get_size() - _position)
+        return nullptr;
+
+    unsigned char const* data = static_cast<unsigned char const*>(_region->get_address()) + _position;
+    _position += numBytes;
+    return data;
 }
 
 std::size_t DB2FileSystemSource::GetPosition() const
 {
-    return ftell(_file);
+    return _position;
 }
 
 std::size_t DB2FileSystemSource::GetFileSize() const
 {
-    boost::system::error_code error;
-    std::size_t size = boost::filesystem::file_size(_fileName, error);
-    return !error ? size : 0;
+    return _region ? _region->get_size() : 0;
 }
 
 char const* DB2FileSystemSource::GetFileName() const
@@ -19,21 +19,33 @@
 #define DB2FileSystemSource_h__
 
 #include "DB2FileLoader.h"
+#include <memory>
 #include <string>
 
+namespace boost
+{
+    namespace interprocess
+    {
+        class mapped_region;
+    }
+}
+
+// Maps the whole file into memory, the file is not kept open
 struct TC_COMMON_API DB2FileSystemSource : public DB2FileSource
 {
     DB2FileSystemSource(std::string const& fileName);
     ~DB2FileSystemSource();
     bool IsOpen() const override;
     bool Read(void* buffer, std::size_t numBytes) override;
+    unsigned char const* ReadInPlace(std::size_t numBytes) override;
     std::size_t GetPosition() const override;
     std::size_t GetFileSize() const override;
     char const* GetFileName() const override;
 
 private:
     std::string _fileName;
-    FILE* _file;
+    std::unique_ptr<boost::interprocess::mapped_region> _region;
+    std::size_t _position;
 };
 
 #endif // DB2FileSystemSource_h__
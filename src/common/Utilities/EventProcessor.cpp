@@ -44,12 +44,10 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    std::multimap<uint64, BasicEvent*>::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    m_events.Advance(m_time, [this, p_time](Trinity::TimerWheelNode* node)
     {
-        // get and remove event from queue
-        BasicEvent* event = i->second;
-        m_events.erase(i);
+        // event was removed from queue by the wheel
+        BasicEvent* event = static_cast<BasicEvent*>(node);
 
         if (event->IsRunning())
         {
@@ -58,7 +56,7 @@ void EventProcessor::Update(uint32 p_time)
                 // completely destroy event if it is not re-added
                 delete event;
             }
-            continue;
+            return;
         }
 
         if (event->IsAbortScheduled())
@@ -71,44 +69,36 @@ void EventProcessor::Update(uint32 p_time)
         if (event->IsDeletable())
         {
             delete event;
-            continue;
+            return;
         }
 
         // Reschedule non deletable events to be checked at
         // the next update tick
         AddEvent(event, CalculateTime(1), false);
-    }
+    });
 }
 
 void EventProcessor::KillAllEvents(bool force)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end();)
+    m_events.RemoveIf([this, force](Trinity::TimerWheelNode* node)
     {
+        BasicEvent* event = static_cast<BasicEvent*>(node);
+
         // Abort events which weren't aborted already
-        if (!itr->second->IsAborted())
+        if (!event->IsAborted())
         {
-            itr->second->SetAborted();
-            itr->second->Abort(m_time);
+            event->SetAborted();
+            event->Abort(m_time);
         }
 
         // Skip non-deletable events when we are
         // not forcing the event cancellation.
-        if (!force && !itr->second->IsDeletable())
-        {
-            ++itr;
-            continue;
-        }
-
-        delete itr->second;
-
-        if (force)
-            ++itr; // Clear the whole container when forcing
-        else
-            itr = m_events.erase(itr);
-    }
+        if (!force && !event->IsDeletable())
+            return false;
 
-    if (force)
-        m_events.clear();
+        delete event;
+        return true;
+    });
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -116,7 +106,7 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
     if (set_addtime)
         Event->m_addTime = m_time;
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    m_events.Schedule(Event, e_time);
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
@@ -20,13 +20,13 @@
 #define __EVENTPROCESSOR_H
 
 #include "Define.h"
-#include <map>
+#include "TimerWheel.h"
 
 class EventProcessor;
 
 // Note. All times are in milliseconds here.
 
-class TC_COMMON_API BasicEvent
+class TC_COMMON_API BasicEvent : public Trinity::TimerWheelNode
 {
         friend class EventProcessor;
 
@@ -81,7 +81,7 @@ class TC_COMMON_API EventProcessor
 
     protected:
         uint64 m_time;
-        std::multimap<uint64, BasicEvent*> m_events;
+        Trinity::TimerWheel m_events;                       // BasicEvents are linked into the wheel, no allocation per event
 };
 
 #endif
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_OBJECTPOOL_H
+#define TRINITY_OBJECTPOOL_H
+
+#include "Define.h"
+#include <atomic>
+#include <new>
+#include <vector>
+
+namespace Trinity
+{
+    struct ObjectPoolStats
+    {
+        std::atomic<uint64> Allocated{ 0 };                 // blocks taken from the global heap
+        std::atomic<uint64> Reused{ 0 };                    // blocks served from a thread free list
+        std::atomic<uint64> Released{ 0 };                  // blocks given back to the global heap
+    };
+
+    /*
+     * Thread local free lists for objects that are created and destroyed at a high rate (spells, auras...).
+     * Memory released on a thread is handed out again by the next allocation of the same size on that thread,
+     * so map update threads recycle their own blocks instead of going through the global allocator.
+     * Tag is the class owning the pool, derived classes share it - blocks are grouped by size.
+     * Meant to back class specific operator new/delete, which should be defined out of line
+     * so that every module uses the pool instance of the module owning the class.
+     */
+    template<class Tag, std::size_t MaxFreeBlocksPerSize = 512>
+    class ObjectPool
+    {
+    public:
+        static void* Allocate(std::size_t size)
+        {
+            ThreadCache& cache = GetThreadCache();
+            SizeClass& sizeClass = cache.GetSizeClass(size);
+            if (FreeBlock* block = sizeClass.Head)
+            {
+                sizeClass.Head = block->Next;
+                --sizeClass.Count;
+                cache.Count(cache.Reused);
+                return block;
+            }
+
+            cache.Count(cache.Allocated);
+            return ::operator new(size);
+        }
+
+        static void Deallocate(void* ptr, std::size_t size)
+        {
+            if (!ptr)
+                return;
+
+            ThreadCache& cache = GetThreadCache();
+            SizeClass& sizeClass = cache.GetSizeClass(size);
+            if (sizeClass.Count >= MaxFreeBlocksPerSize)
+            {
+                cache.Count(cache.Released);
+                ::operator delete(ptr);
+                return;
+            }
+
+            FreeBlock* block = static_cast<FreeBlock*>(ptr);
+            block->Next = sizeClass.Head;
+            sizeClass.Head = block;
+            ++sizeClass.Count;
+        }
+
+        static ObjectPoolStats const& GetStats() { return _stats; }
+
+        // folds the counters of the calling thread into the shared stats right away
+        static void FlushThreadStats() { GetThreadCache().FlushStats(); }
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* Next;
+        };
+
+        struct SizeClass
+        {
+            std::size_t Size;
+            FreeBlock* Head;
+            std::size_t Count;
+        };
+
+        struct ThreadCache
+        {
+            // counters are folded into the shared stats in batches to keep threads off a common cache line
+            static uint32 const StatsFlushInterval = 1024;
+
+            ~ThreadCache()
+            {
+                for (SizeClass& sizeClass : SizeClasses)
+                {
+                    while (FreeBlock* block = sizeClass.Head)
+                    {
+                        sizeClass.Head = block->Next;
+                        ::operator delete(block);
+                        ++Released;
+                    }
+                }
+
+                FlushStats();
+            }
+
+            SizeClass& GetSizeClass(std::size_t size)
+            {
+                // a pool serves only a handful of distinct sizes (the class and its derived classes)
+                for (SizeClass& sizeClass : SizeClasses)
+                    if (sizeClass.Size == size)
+                        return sizeClass;
+
+                SizeClasses.push_back({ size, nullptr, 0 });
+                return SizeClasses.back();
+            }
+
+            void Count(uint32& counter)
+            {
+                ++counter;
+                if (++PendingStats >= StatsFlushInterval)
+                    FlushStats();
+            }
+
+            void FlushStats()
+            {
+                _stats.Allocated.fetch_add(Allocated, std::memory_order_relaxed);
+                _stats.Reused.fetch_add(Reused, std::memory_order_relaxed);
+                _stats.Released.fetch_add(Released, std::memory_order_relaxed);
+                Allocated = Reused = Released = PendingStats = 0;
+            }
+
+            std::vector<SizeClass> SizeClasses;
+            uint32 Allocated = 0;
+            uint32 Reused = 0;
+            uint32 Released = 0;
+            uint32 PendingStats = 0;
+        };
+
+        static ThreadCache& GetThreadCache()
+        {
+            thread_local ThreadCache cache;
+            return cache;
+        }
+
+        static ObjectPoolStats _stats;
+    };
+
+    template<class Tag, std::size_t MaxFreeBlocksPerSize>
+    ObjectPoolStats ObjectPool<Tag, MaxFreeBlocksPerSize>::_stats;
+}
+
+#endif // TRINITY_OBJECTPOOL_H
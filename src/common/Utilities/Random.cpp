@@ -37,6 +37,18 @@ static SFMTRand* GetRng()
     return rand;
 }
 
+RandomSeedScope::RandomSeedScope(uint32 seed) : _previous(sfmtRand.release())
+{
+    SFMTRand* rand = new SFMTRand();
+    rand->RandomInit(int(seed));
+    sfmtRand.reset(rand);
+}
+
+RandomSeedScope::~RandomSeedScope()
+{
+    sfmtRand.reset(_previous);
+}
+
 int32 irand(int32 min, int32 max)
 {
     ASSERT(max >= min);
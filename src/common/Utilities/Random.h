@@ -22,6 +22,22 @@
 #include "Duration.h"
 #include <limits>
 
+class SFMTRand;
+
+/* Reseeds the random number generator of the calling thread while it exists, rolls made meanwhile are reproducible. The previous generator state is restored on destruction. */
+class TC_COMMON_API RandomSeedScope
+{
+public:
+    explicit RandomSeedScope(uint32 seed);
+    ~RandomSeedScope();
+
+    RandomSeedScope(RandomSeedScope const&) = delete;
+    RandomSeedScope& operator=(RandomSeedScope const&) = delete;
+
+private:
+    SFMTRand* _previous;
+};
+
 /* Return a random number in the range min..max. */
 TC_COMMON_API int32 irand(int32 min, int32 max);
 
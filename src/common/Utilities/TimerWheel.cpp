@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TimerWheel.h"
+#include "Errors.h"
+
+#if TRINITY_COMPILER == TRINITY_COMPILER_MICROSOFT
+#include <intrin.h>
+#endif
+
+using namespace Trinity;
+
+namespace
+{
+    uint32 const OverflowSlot = TimerWheel::LevelCount * TimerWheel::SlotCount;
+}
+
+void TimerWheel::Schedule(TimerWheelNode* node, uint64 deadline)
+{
+    ASSERT(!node->IsScheduled(), "Tried to schedule a timer wheel node twice!");
+
+    if (!_slots)
+        _slots.reset(new std::array<TimerWheelNode*, LevelCount * SlotCount>());
+
+    node->_deadline = deadline;
+    Place(node);
+    ++_size;
+}
+
+void TimerWheel::Unschedule(TimerWheelNode* node)
+{
+    if (!node->IsScheduled())
+        return;
+
+    Unlink(node);
+}
+
+void TimerWheel::Place(TimerWheelNode* node)
+{
+    // the level is picked from the highest group of bits the deadline shares with the current time,
+    // so the node is cascaded down exactly when the clock enters the slot range it was put in
+    uint64 deadline = std::max(node->_deadline, _time);
+    uint64 distance = deadline ^ _time;
+
+    uint32 level = 0;
+    while (level < LevelCount && (distance >> (SlotBits * (level + 1))))
+        ++level;
+
+    if (level == LevelCount)
+    {
+        node->_slot = OverflowSlot;
+        Append(_overflow, node);
+        return;
+    }
+
+    uint32 index = uint32(deadline >> (SlotBits * level)) & (SlotCount - 1);
+    node->_slot = level * SlotCount + index;
+    Append((*_slots)[node->_slot], node);
+    _occupied[level] |= UI64LIT(1) << index;
+}
+
+void TimerWheel::Unlink(TimerWheelNode* node)
+{
+    TimerWheelNode*& head = node->_slot == OverflowSlot ? _overflow : (*_slots)[node->_slot];
+    if (node->_next == node)
+    {
+        head = nullptr;
+        if (node->_slot != OverflowSlot)
+            _occupied[node->_slot / SlotCount] &= ~(UI64LIT(1) << (node->_slot % SlotCount));
+    }
+    else
+    {
+        node->_prev->_next = node->_next;
+        node->_next->_prev = node->_prev;
+        if (head == node)
+            head = node->_next;
+    }
+
+    node->_prev = node->_next = nullptr;
+    --_size;
+}
+
+void TimerWheel::Cascade()
+{
+    auto cascade = [this](TimerWheelNode*& head)
+    {
+        TimerWheelNode* node = head;
+        if (!node)
+            return;
+
+        head = nullptr;
+        node->_prev->_next = nullptr;
+        while (node)
+        {
+            TimerWheelNode* next = node->_next;
+            node->_prev = node->_next = nullptr;
+            Place(node);
+            node = next;
+        }
+    };
+
+    for (uint32 level = 1; level < LevelCount; ++level)
+    {
+        if (_time & ((UI64LIT(1) << (SlotBits * level)) - 1))
+            return;
+
+        uint32 index = uint32(_time >> (SlotBits * level)) & (SlotCount - 1);
+        _occupied[level] &= ~(UI64LIT(1) << index);
+        cascade((*_slots)[level * SlotCount + index]);
+    }
+
+    if (!(_time & ((UI64LIT(1) << (SlotBits * LevelCount)) - 1)))
+        cascade(_overflow);
+}
+
+void TimerWheel::Detach(TimerWheelNode*& head, std::vector<TimerWheelNode*>& nodes)
+{
+    TimerWheelNode* node = head;
+    if (!node)
+        return;
+
+    head = nullptr;
+    node->_prev->_next = nullptr;
+    while (node)
+    {
+        TimerWheelNode* next = node->_next;
+        node->_prev = node->_next = nullptr;
+        nodes.push_back(node);
+        --_size;
+        node = next;
+    }
+}
+
+void TimerWheel::Append(TimerWheelNode*& head, TimerWheelNode* node)
+{
+    if (!head)
+    {
+        node->_prev = node->_next = node;
+        head = node;
+        return;
+    }
+
+    node->_prev = head->_prev;
+    node->_next = head;
+    head->_prev->_next = node;
+    head->_prev = node;
+}
+
+uint32 TimerWheel::FindFirstSet(uint64 mask)
+{
+#if TRINITY_COMPILER == TRINITY_COMPILER_MICROSOFT
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return uint32(index);
+#else
+    return uint32(__builtin_ctzll(mask));
+#endif
+}
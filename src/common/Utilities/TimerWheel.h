@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_TIMERWHEEL_H
+#define TRINITY_TIMERWHEEL_H
+
+#include "Define.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace Trinity
+{
+    // Base class of everything a TimerWheel can hold, the wheel links its nodes intrusively
+    class TC_COMMON_API TimerWheelNode
+    {
+        friend class TimerWheel;
+
+    public:
+        TimerWheelNode() : _prev(nullptr), _next(nullptr), _deadline(0), _slot(0) { }
+
+        // copies start unscheduled, links belong to the wheel holding the original
+        TimerWheelNode(TimerWheelNode const& right) : _prev(nullptr), _next(nullptr), _deadline(right._deadline), _slot(0) { }
+        TimerWheelNode& operator=(TimerWheelNode const& /*right*/) { return *this; }
+
+        bool IsScheduled() const { return _next != nullptr; }
+        uint64 GetDeadline() const { return _deadline; }
+
+    private:
+        TimerWheelNode* _prev;
+        TimerWheelNode* _next;
+        uint64 _deadline;
+        uint32 _slot;
+    };
+
+    /*
+     * Hierarchical timer wheel with millisecond resolution.
+     * Scheduling and unscheduling are O(1) and never allocate, advancing the clock only touches
+     * the slots holding due nodes (plus one cascade every 16 ms while far away nodes are pending).
+     * Nodes expire in deadline order, nodes sharing a deadline in the order they were scheduled.
+     * The wheel does not own its nodes.
+     */
+    class TC_COMMON_API TimerWheel
+    {
+    public:
+        // small levels keep the slot array at 768 bytes, every object with pending events owns one
+        static uint32 const SlotBits = 4;
+        static uint32 const SlotCount = 1 << SlotBits;
+        static uint32 const LevelCount = 6;                 // covers 2^24 ms (~4.6 hours), later deadlines wait in an overflow list
+
+        TimerWheel() : _occupied(), _overflow(nullptr), _time(0), _size(0) { }
+
+        TimerWheel(TimerWheel const&) = delete;
+        TimerWheel& operator=(TimerWheel const&) = delete;
+
+        // first time that was not expired yet
+        uint64 GetTime() const { return _time; }
+        std::size_t GetSize() const { return _size; }
+        bool IsEmpty() const { return _size == 0; }
+
+        // deadlines in the past expire on the next Advance
+        void Schedule(TimerWheelNode* node, uint64 deadline);
+        void Unschedule(TimerWheelNode* node);
+
+        // expires every node with a deadline <= now, unscheduling it before calling expire(node)
+        // nodes scheduled from expire with a deadline <= now expire within the same call
+        template<class Expire>
+        void Advance(uint64 now, Expire&& expire)
+        {
+            while (_time <= now)
+            {
+                if (!_size)
+                {
+                    _time = now + 1;
+                    break;
+                }
+
+                uint32 slot = uint32(_time & (SlotCount - 1));
+                while (TimerWheelNode* node = GetHead(slot))
+                {
+                    Unlink(node);
+                    expire(node);
+                }
+
+                ++_time;
+
+                // jump to the next occupied slot of the first level, or to the next cascade
+                uint32 index = uint32(_time & (SlotCount - 1));
+                if (index)
+                {
+                    uint64 pending = _occupied[0] >> index;
+                    uint64 next = pending ? _time + FindFirstSet(pending) : (_time | (SlotCount - 1)) + 1;
+                    _time = std::min(next, now + 1);
+                    index = uint32(_time & (SlotCount - 1));
+                }
+
+                // cascade as soon as a boundary is reached so nodes scheduled in between keep their order
+                if (!index)
+                    Cascade();
+            }
+        }
+
+        // calls remove(node) for every scheduled node, nodes it returns true for are unscheduled
+        // and not touched anymore by the wheel (remove may delete them)
+        // remove may schedule and unschedule nodes, nodes scheduled while it runs are not visited
+        template<class Remove>
+        void RemoveIf(Remove&& remove)
+        {
+            // empty the wheel before the first call so every list remove can reach is consistent
+            std::vector<TimerWheelNode*> nodes;
+            nodes.reserve(_size);
+            Detach(_overflow, nodes);
+            if (_slots)
+                for (TimerWheelNode*& head : *_slots)
+                    Detach(head, nodes);
+            _occupied.fill(0);
+
+            for (TimerWheelNode* node : nodes)
+            {
+                // scheduled again by an earlier call
+                if (node->IsScheduled())
+                    continue;
+
+                if (!remove(node))
+                {
+                    Place(node);
+                    ++_size;
+                }
+            }
+        }
+
+    private:
+        TimerWheelNode* GetHead(uint32 slot) const { return _slots ? (*_slots)[slot] : nullptr; }
+
+        void Place(TimerWheelNode* node);
+        void Unlink(TimerWheelNode* node);
+        void Cascade();
+
+        void Detach(TimerWheelNode*& head, std::vector<TimerWheelNode*>& nodes);
+
+        static void Append(TimerWheelNode*& head, TimerWheelNode* node);
+        static uint32 FindFirstSet(uint64 mask);
+
+        std::unique_ptr<std::array<TimerWheelNode*, LevelCount * SlotCount>> _slots;    // allocated with the first node
+        std::array<uint64, LevelCount> _occupied;           // one bit per non empty slot
+        TimerWheelNode* _overflow;
+        uint64 _time;
+        std::size_t _size;
+    };
+}
+
+#endif // TRINITY_TIMERWHEEL_H
@@ -239,6 +239,9 @@ class TC_GAME_API CreatureAI : public UnitAI
 
         virtual bool CanSeeAlways(WorldObject const* /*obj*/) { return false; }
 
+        // Scripted AIs return true while updating them at a reduced rate far from players (Creature.AIUpdateLOD) cannot change their behaviour
+        virtual bool CanThrottleUpdate() const { return false; }
+
         // Called when a player is charmed by the creature
         // If a PlayerAI* is returned, that AI is placed on the player instead of the default charm AI
         // Object destruction is handled by Unit::RemoveCharmedBy
@@ -395,6 +395,12 @@ void SmartAI::UpdateAI(uint32 diff)
         DoMeleeAttackIfReady();
 }
 
+bool SmartAI::CanThrottleUpdate() const
+{
+    // nothing timed is running: no event timers, waypoints, follow or despawn
+    return mEscortState == SMART_ESCORT_NONE && mFollowGuid.IsEmpty() && !mDespawnState && !mScript.HasOutOfCombatUpdates();
+}
+
 bool SmartAI::IsEscortInvokerInRange()
 {
     ObjectList* targets = GetScript()->GetTargetList(SMART_ESCORT_TARGETS);
@@ -194,6 +194,8 @@ class TC_GAME_API SmartAI : public CreatureAI
 
         void OnSpellClick(Unit* clicker, bool& result) override;
 
+        bool CanThrottleUpdate() const override;
+
     private:
         bool mIsCharmed;
         uint32 mFollowCreditType;
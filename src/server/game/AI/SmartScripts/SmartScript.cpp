@@ -18,6 +18,7 @@
 #include "SmartScript.h"
 #include "CellImpl.h"
 #include "ChatTextBuilder.h"
+#include "ConditionMgr.h"
 #include "Creature.h"
 #include "CreatureTextMgr.h"
 #include "CreatureTextMgrImpl.h"
@@ -43,6 +44,47 @@
 #include "TemporarySummon.h"
 #include "Vehicle.h"
 
+namespace
+{
+    // events processed by UpdateTimer when their timer expires, the others only use it as a cooldown
+    bool IsTimedEvent(uint32 eventType)
+    {
+        switch (eventType)
+        {
+            case SMART_EVENT_UPDATE:
+            case SMART_EVENT_UPDATE_OOC:
+            case SMART_EVENT_UPDATE_IC:
+            case SMART_EVENT_HEALT_PCT:
+            case SMART_EVENT_TARGET_HEALTH_PCT:
+            case SMART_EVENT_MANA_PCT:
+            case SMART_EVENT_TARGET_MANA_PCT:
+            case SMART_EVENT_RANGE:
+            case SMART_EVENT_VICTIM_CASTING:
+            case SMART_EVENT_FRIENDLY_HEALTH:
+            case SMART_EVENT_FRIENDLY_IS_CC:
+            case SMART_EVENT_FRIENDLY_MISSING_BUFF:
+            case SMART_EVENT_HAS_AURA:
+            case SMART_EVENT_TARGET_BUFFED:
+            case SMART_EVENT_IS_BEHIND_TARGET:
+            case SMART_EVENT_FRIENDLY_HEALTH_PCT:
+            case SMART_EVENT_DISTANCE_CREATURE:
+            case SMART_EVENT_DISTANCE_GAMEOBJECT:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // whether UpdateTimer has anything to do for the event, idle events only wait for ProcessEventsFor
+    bool IsTimerRunning(SmartScriptHolder const& e)
+    {
+        if (e.GetEventType() == SMART_EVENT_LINK)
+            return false;
+
+        return e.timer || !e.active || IsTimedEvent(e.GetEventType());
+    }
+}
+
 SmartScript::SmartScript()
 {
     go = nullptr;
@@ -59,6 +101,8 @@ SmartScript::SmartScript()
     mTemplate = SMARTAI_TEMPLATE_BASIC;
     mScriptType = SMART_SCRIPT_TYPE_CREATURE;
     isProcessingTimedActionList = false;
+    mEventIndexOffsets.fill(0);
+    mEventIndexConditionsLoadCount = 0;
 }
 
 SmartScript::~SmartScript()
@@ -224,18 +268,95 @@ void SmartScript::ResetBaseObject()
 
 void SmartScript::ProcessEventsFor(SMART_EVENT e, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob, std::string const& varString)
 {
-    for (SmartAIEventList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
+    if (e == SMART_EVENT_LINK || e >= SMART_EVENT_END)//special handling
+        return;
+
+    // conditions were reloaded, the cached condition lists are gone
+    if (mEventIndexConditionsLoadCount != sConditionMgr->GetLoadCount())
+        ResolveEventConditions();
+
+    for (uint32 i = mEventIndexOffsets[e]; i < mEventIndexOffsets[e + 1] && i < mEventIndex.size(); ++i)
     {
-        SMART_EVENT eventType = SMART_EVENT(i->GetEventType());
-        if (eventType == SMART_EVENT_LINK)//special handling
-            continue;
+        uint32 eventIndex = mEventIndex[i];
+        if (std::vector<Condition*> const* conditions = mEventConditions[eventIndex])
+        {
+            ConditionSourceInfo sourceInfo(unit, GetBaseObject());
+            if (!sConditionMgr->IsObjectMeetToConditions(sourceInfo, *conditions))
+                continue;
+        }
 
-        if (eventType == e /*&& (!i->event.event_phase_mask || IsInPhase(i->event.event_phase_mask)) && !(i->event.event_flags & SMART_EVENT_FLAG_NOT_REPEATABLE && i->runOnce)*/)
-            if (sConditionMgr->IsObjectMeetingSmartEventConditions(i->entryOrGuid, i->event_id, i->source_type, unit, GetBaseObject()))
-                ProcessEvent(*i, unit, var0, var1, bvar, spell, gob, varString);
+        ProcessEvent(mEvents[eventIndex], unit, var0, var1, bvar, spell, gob, varString);
     }
 }
 
+bool SmartScript::IsMeetingEventConditions(SmartScriptHolder const& e, Unit* unit)
+{
+    // stored events and timed action lists are not indexed, look their conditions up
+    if (mEvents.empty() || &e < mEvents.data() || &e >= mEvents.data() + mEvents.size())
+        return sConditionMgr->IsObjectMeetingSmartEventConditions(e.entryOrGuid, e.event_id, e.source_type, unit, GetBaseObject());
+
+    if (mEventIndexConditionsLoadCount != sConditionMgr->GetLoadCount() || mEventConditions.size() != mEvents.size())
+        ResolveEventConditions();
+
+    std::vector<Condition*> const* conditions = mEventConditions[&e - mEvents.data()];
+    if (!conditions)
+        return true;
+
+    ConditionSourceInfo sourceInfo(unit, GetBaseObject());
+    return sConditionMgr->IsObjectMeetToConditions(sourceInfo, *conditions);
+}
+
+void SmartScript::BuildEventIndex()
+{
+    mEventIndex.clear();
+    mEventIndex.reserve(mEvents.size());
+    mEventIndexOffsets.fill(0);
+
+    // counting sort on the event type, keeps the database order of the events inside each type
+    for (SmartScriptHolder const& holder : mEvents)
+        if (holder.GetEventType() < SMART_EVENT_END)
+            ++mEventIndexOffsets[holder.GetEventType() + 1];
+
+    for (uint32 type = 1; type <= SMART_EVENT_END; ++type)
+        mEventIndexOffsets[type] += mEventIndexOffsets[type - 1];
+
+    std::array<uint16, SMART_EVENT_END + 1> insertPos = mEventIndexOffsets;
+    mEventIndex.resize(mEventIndexOffsets[SMART_EVENT_END]);
+    for (uint32 i = 0; i < mEvents.size(); ++i)
+        if (mEvents[i].GetEventType() < SMART_EVENT_END)
+            mEventIndex[insertPos[mEvents[i].GetEventType()]++] = i;
+
+    ResolveEventConditions();
+
+    mTickingEvents.clear();
+    mEventTicking.assign(mEvents.size(), false);
+    for (uint32 i = 0; i < mEvents.size(); ++i)
+        StartEventTimer(mEvents[i]);
+}
+
+void SmartScript::ResolveEventConditions()
+{
+    mEventConditions.resize(mEvents.size());
+    for (uint32 i = 0; i < mEvents.size(); ++i)
+        mEventConditions[i] = sConditionMgr->GetConditionsForSmartEvent(mEvents[i].entryOrGuid, mEvents[i].event_id, mEvents[i].source_type);
+
+    mEventIndexConditionsLoadCount = sConditionMgr->GetLoadCount();
+}
+
+void SmartScript::StartEventTimer(SmartScriptHolder const& e)
+{
+    // stored events and timed action lists are always updated
+    if (mEvents.empty() || &e < mEvents.data() || &e >= mEvents.data() + mEvents.size())
+        return;
+
+    uint32 index = uint32(&e - mEvents.data());
+    if (mEventTicking[index] || !IsTimerRunning(e))
+        return;
+
+    mEventTicking[index] = true;
+    mTickingEvents.push_back(index);
+}
+
 void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob, std::string const& varString)
 {
     //calc random
@@ -411,7 +532,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                     //set model based on entry from creature_template
                     if (e.action.morphOrMount.creature)
                     {
-                        if (CreatureTemplate const* ci = sObjectMgr->GetCreatureTemplate(e.action.morphOrMount.creature))
+                        if (CreatureTemplate const* ci = e.actionCreatureTemplate)
                         {
                             uint32 displayId = ObjectMgr::ChooseDisplayId(ci);
                             (*itr)->ToCreature()->SetDisplayId(displayId);
@@ -654,7 +775,8 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                             // unless target is outside spell range, out of mana, or LOS.
 
                             bool _allowMove = false;
-                            SpellInfo const* spellInfo = sSpellMgr->AssertSpellInfo(e.action.cast.spell);
+                            SpellInfo const* spellInfo = e.actionSpellInfo;
+                            ASSERT(spellInfo);
                             std::vector<SpellPowerCost> costs = spellInfo->CalcPowerCost(me, spellInfo->GetSchoolMask());
                             bool hasPower = true;
                             for (SpellPowerCost const& cost : costs)
@@ -686,7 +808,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                             ENSURE_AI(SmartAI, me->AI())->SetCombatMove(_allowMove);
                         }
 
-                        me->CastSpell((*itr)->ToUnit(), e.action.cast.spell, triggerFlag);
+                        me->CastSpell((*itr)->ToUnit(), e.actionSpellInfo, triggerFlag);
                     }
                     else if (go)
                         go->CastSpell((*itr)->ToUnit(), e.action.cast.spell, triggerFlag);
@@ -735,7 +857,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                             triggerFlag = TRIGGERED_FULL_MASK;
                     }
 
-                    tempLastInvoker->CastSpell((*itr)->ToUnit(), e.action.cast.spell, triggerFlag);
+                    tempLastInvoker->CastSpell((*itr)->ToUnit(), e.actionSpellInfo, triggerFlag);
                     TC_LOG_DEBUG("scripts.ai", "SmartScript::ProcessAction:: SMART_ACTION_INVOKER_CAST: Invoker %s casts spell %u on target %s with castflags %u",
                         tempLastInvoker->GetGUID().ToString().c_str(), e.action.cast.spell, (*itr)->GetGUID().ToString().c_str(), e.action.cast.castFlags);
                 }
@@ -1296,7 +1418,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                 {
                     if (e.action.morphOrMount.creature > 0)
                     {
-                        if (CreatureTemplate const* cInfo = sObjectMgr->GetCreatureTemplate(e.action.morphOrMount.creature))
+                        if (CreatureTemplate const* cInfo = e.actionCreatureTemplate)
                             (*itr)->ToUnit()->Mount(ObjectMgr::ChooseDisplayId(cInfo));
                     }
                     else
@@ -1971,7 +2093,10 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
         }
         case SMART_ACTION_CROSS_CAST:
         {
-            ObjectList* casters = GetTargets(CreateSmartEvent(SMART_EVENT_UPDATE_IC, 0, 0, 0, 0, 0, SMART_ACTION_NONE, 0, 0, 0, 0, 0, 0, (SMARTAI_TARGETS)e.action.crossCast.targetType, e.action.crossCast.targetParam1, e.action.crossCast.targetParam2, e.action.crossCast.targetParam3, 0), unit);
+            // GetTargets only reads the target of the holder, no need for a full CreateSmartEvent
+            SmartScriptHolder casterSelector;
+            casterSelector.target = SmartTarget((SMARTAI_TARGETS)e.action.crossCast.targetType, e.action.crossCast.targetParam1, e.action.crossCast.targetParam2, e.action.crossCast.targetParam3);
+            ObjectList* casters = GetTargets(casterSelector, unit);
             if (!casters)
                 break;
 
@@ -2004,7 +2129,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
                             interruptedSpell = true;
                         }
 
-                        targetUnit->CastSpell((*it)->ToUnit(), e.action.crossCast.spell, (e.action.crossCast.castFlags & SMARTCAST_TRIGGERED) != 0);
+                        targetUnit->CastSpell((*it)->ToUnit(), e.actionSpellInfo, (e.action.crossCast.castFlags & SMARTCAST_TRIGGERED) != 0);
                     }
                     else
                         TC_LOG_DEBUG("scripts.ai", "Spell %u not cast because it has flag SMARTCAST_AURA_NOT_PRESENT and the target (%s) already has the aura", e.action.crossCast.spell, (*it)->GetGUID().ToString().c_str());
@@ -2928,7 +3053,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
 
 void SmartScript::ProcessTimedAction(SmartScriptHolder& e, uint32 const& min, uint32 const& max, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob, std::string const& varString)
 {
-    if (sConditionMgr->IsObjectMeetingSmartEventConditions(e.entryOrGuid, e.event_id, e.source_type, unit, GetBaseObject()))
+    if (IsMeetingEventConditions(e, unit))
         ProcessAction(e, unit, var0, var1, bvar, spell, gob, varString);
 
     RecalcTimer(e, min, max);
@@ -3039,6 +3164,7 @@ SmartScriptHolder SmartScript::CreateSmartEvent(SMART_EVENT e, uint32 event_flag
     script.target.raw.param3 = target_param3;
 
     script.source_type = SMART_SCRIPT_TYPE_CREATURE;
+    SmartAIMgr::ResolveActionData(script);
     InitTimer(script);
     return script;
 }
@@ -3957,6 +4083,7 @@ void SmartScript::RecalcTimer(SmartScriptHolder& e, uint32 min, uint32 max)
     // min/max was checked at loading!
     e.timer = urand(min, max);
     e.active = e.timer ? false : true;
+    StartEventTimer(e);
 }
 
 void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
@@ -3999,42 +4126,21 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
         }
 
         e.active = true;//activate events with cooldown
-        switch (e.GetEventType())//process ONLY timed events
+        if (IsTimedEvent(e.GetEventType()))//process ONLY timed events
         {
-            case SMART_EVENT_UPDATE:
-            case SMART_EVENT_UPDATE_OOC:
-            case SMART_EVENT_UPDATE_IC:
-            case SMART_EVENT_HEALT_PCT:
-            case SMART_EVENT_TARGET_HEALTH_PCT:
-            case SMART_EVENT_MANA_PCT:
-            case SMART_EVENT_TARGET_MANA_PCT:
-            case SMART_EVENT_RANGE:
-            case SMART_EVENT_VICTIM_CASTING:
-            case SMART_EVENT_FRIENDLY_HEALTH:
-            case SMART_EVENT_FRIENDLY_IS_CC:
-            case SMART_EVENT_FRIENDLY_MISSING_BUFF:
-            case SMART_EVENT_HAS_AURA:
-            case SMART_EVENT_TARGET_BUFFED:
-            case SMART_EVENT_IS_BEHIND_TARGET:
-            case SMART_EVENT_FRIENDLY_HEALTH_PCT:
-            case SMART_EVENT_DISTANCE_CREATURE:
-            case SMART_EVENT_DISTANCE_GAMEOBJECT:
+            ProcessEvent(e);
+            if (e.GetScriptType() == SMART_SCRIPT_TYPE_TIMED_ACTIONLIST)
             {
-                ProcessEvent(e);
-                if (e.GetScriptType() == SMART_SCRIPT_TYPE_TIMED_ACTIONLIST)
+                e.enableTimed = false;//disable event if it is in an ActionList and was processed once
+                for (SmartAIEventList::iterator i = mTimedActionList.begin(); i != mTimedActionList.end(); ++i)
                 {
-                    e.enableTimed = false;//disable event if it is in an ActionList and was processed once
-                    for (SmartAIEventList::iterator i = mTimedActionList.begin(); i != mTimedActionList.end(); ++i)
+                    //find the first event which is not the current one and enable it
+                    if (i->event_id > e.event_id)
                     {
-                        //find the first event which is not the current one and enable it
-                        if (i->event_id > e.event_id)
-                        {
-                            i->enableTimed = true;
-                            break;
-                        }
+                        i->enableTimed = true;
+                        break;
                     }
                 }
-                break;
             }
         }
     }
@@ -4055,6 +4161,7 @@ void SmartScript::InstallEvents()
             mEvents.push_back(*i);//must be before UpdateTimers
 
         mInstallEvents.clear();
+        BuildEventIndex();
     }
 }
 
@@ -4131,8 +4238,19 @@ void SmartScript::OnUpdate(uint32 const diff)
 
     InstallEvents();//before UpdateTimers
 
-    for (SmartAIEventList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
-        UpdateTimer(*i, diff);
+    // events started during this loop get their first update on the next tick
+    std::size_t tickingCount = mTickingEvents.size();
+    for (std::size_t i = 0; i < tickingCount && i < mTickingEvents.size(); ++i)
+        UpdateTimer(mEvents[mTickingEvents[i]], diff);
+
+    mTickingEvents.erase(std::remove_if(mTickingEvents.begin(), mTickingEvents.end(), [this](uint32 index)
+    {
+        if (IsTimerRunning(mEvents[index]))
+            return false;
+
+        mEventTicking[index] = false;
+        return true;
+    }), mTickingEvents.end());
 
     if (!mStoredEvents.empty())
         for (SmartAIEventList::iterator i = mStoredEvents.begin(); i != mStoredEvents.end(); ++i)
@@ -4178,6 +4296,19 @@ void SmartScript::OnUpdate(uint32 const diff)
     }
 }
 
+bool SmartScript::HasOutOfCombatUpdates() const
+{
+    if (!mInstallEvents.empty() || !mStoredEvents.empty() || !mTimedActionList.empty() || !mRemIDs.empty() || mUseTextTimer)
+        return true;
+
+    // in combat update events keep their timer running but only tick in combat
+    for (uint32 index : mTickingEvents)
+        if (mEvents[index].GetEventType() != SMART_EVENT_UPDATE_IC)
+            return true;
+
+    return false;
+}
+
 void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEntry const* at, SceneTemplate const* scene)
 {
     if (e.empty())
@@ -4259,6 +4390,8 @@ void SmartScript::GetScript()
         e = sSmartScriptMgr->GetScript(sceneTemplate->SceneId, mScriptType);
         FillScript(std::move(e), nullptr, nullptr, sceneTemplate);
     }
+
+    BuildEventIndex();
 }
 
 void SmartScript::OnInitialize(WorldObject* obj, AreaTriggerEntry const* at, SceneTemplate const* scene)
@@ -20,7 +20,10 @@
 
 #include "Define.h"
 #include "SmartScriptMgr.h"
+#include <array>
+#include <vector>
 
+class Condition;
 class Creature;
 class GameObject;
 class Player;
@@ -73,6 +76,8 @@ class TC_GAME_API SmartScript
         Unit* DoFindClosestFriendlyInRange(float range, bool playerOnly);
 
         bool IsSmart(Creature* c = NULL);
+        // true while OnUpdate has work out of combat: running event timers, timed action lists, stored events or a text timer
+        bool HasOutOfCombatUpdates() const;
         bool IsSmartGO(GameObject* g = NULL);
 
         void StoreTargetList(ObjectList* targets, uint32 id);
@@ -119,6 +124,21 @@ class TC_GAME_API SmartScript
 
         SmartAIEventList mEvents;
         SmartAIEventList mInstallEvents;
+
+        // positions in mEvents grouped by event type, so ProcessEventsFor only walks the events it fires
+        std::vector<uint32> mEventIndex;                                // sorted by event type
+        std::array<uint16, SMART_EVENT_END + 1> mEventIndexOffsets;     // first entry of each event type in mEventIndex
+        std::vector<std::vector<Condition*> const*> mEventConditions;   // smart event conditions of each mEvents entry, nullptr if there are none
+        uint32 mEventIndexConditionsLoadCount;                          // ConditionMgr load the condition pointers were resolved from
+        void BuildEventIndex();
+        void ResolveEventConditions();
+        bool IsMeetingEventConditions(SmartScriptHolder const& e, Unit* unit);
+
+        // positions in mEvents of the events with a running timer, OnUpdate skips the others
+        std::vector<uint32> mTickingEvents;
+        std::vector<bool> mEventTicking;
+        void StartEventTimer(SmartScriptHolder const& e);
+
         SmartAIEventList mTimedActionList;
         bool isProcessingTimedActionList;
         Creature* me;
@@ -260,6 +260,8 @@ void SmartAIMgr::LoadSmartAIFromDB()
         if (!IsEventValid(temp))
             continue;
 
+        ResolveActionData(temp);
+
         // creature entry / guid not found in storage, create empty event list for it and increase counters
         if (mEventMap[source_type].find(temp.entryOrGuid) == mEventMap[source_type].end())
         {
@@ -453,6 +455,27 @@ bool SmartAIMgr::NotNULL(SmartScriptHolder const& e, uint32 data)
     return true;
 }
 
+void SmartAIMgr::ResolveActionData(SmartScriptHolder& e)
+{
+    switch (e.GetActionType())
+    {
+        case SMART_ACTION_CAST:
+        case SMART_ACTION_INVOKER_CAST:
+            e.actionSpellInfo = sSpellMgr->GetSpellInfo(e.action.cast.spell);
+            break;
+        case SMART_ACTION_CROSS_CAST:
+            e.actionSpellInfo = sSpellMgr->GetSpellInfo(e.action.crossCast.spell);
+            break;
+        case SMART_ACTION_MORPH_TO_ENTRY_OR_MODEL:
+        case SMART_ACTION_MOUNT_TO_ENTRY_OR_MODEL:
+            if (e.action.morphOrMount.creature)
+                e.actionCreatureTemplate = sObjectMgr->GetCreatureTemplate(e.action.morphOrMount.creature);
+            break;
+        default:
+            break;
+    }
+}
+
 bool SmartAIMgr::IsCreatureValid(SmartScriptHolder const& e, uint32 entry)
 {
     if (!sObjectMgr->GetCreatureTemplate(entry))
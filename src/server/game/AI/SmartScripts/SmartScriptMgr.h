@@ -24,8 +24,10 @@
 #include <string>
 #include <unordered_map>
 
+class SpellInfo;
 class WorldObject;
 enum SpellEffIndex : uint8;
+struct CreatureTemplate;
 
 struct WayPoint
 {
@@ -1547,8 +1549,8 @@ enum SmartCastFlags
 struct SmartScriptHolder
 {
     SmartScriptHolder() : entryOrGuid(0), source_type(SMART_SCRIPT_TYPE_CREATURE)
-        , event_id(0), link(0), event(), action(), target(), timer(0), active(false), runOnce(false)
-        , enableTimed(false) { }
+        , event_id(0), link(0), event(), action(), target(), actionSpellInfo(nullptr), actionCreatureTemplate(nullptr)
+        , timer(0), active(false), runOnce(false), enableTimed(false) { }
 
     int64 entryOrGuid;
     SmartScriptType source_type;
@@ -1559,6 +1561,10 @@ struct SmartScriptHolder
     SmartAction action;
     SmartTarget target;
 
+    // resolved from the action params by SmartAIMgr::ResolveActionData, ProcessAction does not look them up again
+    SpellInfo const* actionSpellInfo;
+    CreatureTemplate const* actionCreatureTemplate;
+
     uint32 GetScriptType() const { return (uint32)source_type; }
     uint32 GetEventType() const { return (uint32)event.type; }
     uint32 GetActionType() const { return (uint32)action.type; }
@@ -1650,6 +1656,8 @@ class TC_GAME_API SmartAIMgr
 
         static SmartScriptHolder& FindLinkedEvent(SmartAIEventList& list, uint32 link);
 
+        static void ResolveActionData(SmartScriptHolder& e);
+
     private:
         //event stores
         SmartAIEventMap mEventMap[SMART_SCRIPT_TYPE_MAX];
@@ -261,6 +261,37 @@ void ThreatContainer::clearReferences()
     }
 
     iThreatList.clear();
+    iThreatIndex.clear();
+}
+
+//============================================================
+
+void ThreatContainer::remove(HostileReference* hostileRef)
+{
+    auto itr = iThreatIndex.find(hostileRef->getUnitGuid());
+    if (itr == iThreatIndex.end() || *itr->second != hostileRef)
+        return;
+
+    iThreatList.erase(itr->second);
+    iThreatIndex.erase(itr);
+}
+
+//============================================================
+
+void ThreatContainer::addReference(HostileReference* hostileRef)
+{
+    auto itr = iThreatIndex.find(hostileRef->getUnitGuid());
+    if (itr != iThreatIndex.end())
+    {
+        if (*itr->second == hostileRef)
+            return;
+
+        // keep a single entry per target, the newest reference replaces the old one
+        iThreatList.erase(itr->second);
+        iThreatIndex.erase(itr);
+    }
+
+    iThreatIndex[hostileRef->getUnitGuid()] = iThreatList.insert(iThreatList.end(), hostileRef);
 }
 
 //============================================================
@@ -270,15 +301,11 @@ HostileReference* ThreatContainer::getReferenceByTarget(Unit* victim) const
     if (!victim)
         return NULL;
 
-    ObjectGuid guid = victim->GetGUID();
-    for (ThreatContainer::StorageType::const_iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
-    {
-        HostileReference* ref = (*i);
-        if (ref && ref->getUnitGuid() == guid)
-            return ref;
-    }
+    auto itr = iThreatIndex.find(victim->GetGUID());
+    if (itr == iThreatIndex.end())
+        return NULL;
 
-    return NULL;
+    return *itr->second;
 }
 
 //============================================================
@@ -306,7 +333,39 @@ void ThreatContainer::modifyThreatPercent(Unit* victim, int32 percent)
 void ThreatContainer::update()
 {
     if (iDirty && iThreatList.size() > 1)
-        iThreatList.sort(Trinity::ThreatOrderPred());
+    {
+        Trinity::ThreatOrderPred pred;
+
+        // splicing costs up to one list walk per out of order reference, when many moved
+        // (aoe threat, threat wipes) sorting the whole list is cheaper
+        uint32 const maxSplicedReferences = 8;
+        uint32 outOfOrder = 0;
+        for (StorageType::iterator itr = std::next(iThreatList.begin()); itr != iThreatList.end() && outOfOrder <= maxSplicedReferences; ++itr)
+            if (pred(*itr, *std::prev(itr)))
+                ++outOfOrder;
+
+        if (outOfOrder > maxSplicedReferences)
+        {
+            iThreatList.sort(pred);
+            iDirty = false;
+            return;
+        }
+
+        // only a few references moved, each of them is spliced back to its place (stable, like list::sort)
+        StorageType::iterator itr = std::next(iThreatList.begin());
+        while (itr != iThreatList.end())
+        {
+            StorageType::iterator next = std::next(itr);
+            StorageType::iterator pos = itr;
+            while (pos != iThreatList.begin() && pred(*itr, *std::prev(pos)))
+                --pos;
+
+            if (pos != itr)
+                iThreatList.splice(pos, iThreatList, itr);
+
+            itr = next;
+        }
+    }
 
     iDirty = false;
 }
@@ -26,6 +26,7 @@
 #include "ObjectGuid.h"
 
 #include <list>
+#include <unordered_map>
 
 //==============================================================
 
@@ -180,15 +181,9 @@ class TC_GAME_API ThreatContainer
         StorageType const & getThreatList() const { return iThreatList; }
 
     private:
-        void remove(HostileReference* hostileRef)
-        {
-            iThreatList.remove(hostileRef);
-        }
+        void remove(HostileReference* hostileRef);
 
-        void addReference(HostileReference* hostileRef)
-        {
-            iThreatList.push_back(hostileRef);
-        }
+        void addReference(HostileReference* hostileRef);
 
         void clearReferences();
 
@@ -196,6 +191,7 @@ class TC_GAME_API ThreatContainer
         void update();
 
         StorageType iThreatList;
+        std::unordered_map<ObjectGuid, StorageType::iterator> iThreatIndex; // list iterators stay valid through sort and splice
         bool iDirty;
 };
 
@@ -39,6 +39,8 @@
 #include "SpellMgr.h"
 #include "World.h"
 #include "WorldSession.h"
+#include <boost/container/small_vector.hpp>
+#include <unordered_set>
 
 char const* const ConditionMgr::StaticSourceTypeData[CONDITION_SOURCE_TYPE_MAX] =
 {
@@ -721,6 +723,46 @@ uint32 Condition::GetSearcherTypeMaskForCondition() const
     return mask;
 }
 
+uint32 Condition::GetEvaluationCost() const
+{
+    // relative cost of Meets, lists evaluate cheap conditions first so a failing one skips the expensive checks of its else group
+    if (ReferenceId || ScriptId)
+        return 2;
+
+    switch (ConditionType)
+    {
+        case CONDITION_NONE:
+        case CONDITION_ZONEID:
+        case CONDITION_TEAM:
+        case CONDITION_CLASS:
+        case CONDITION_RACE:
+        case CONDITION_GENDER:
+        case CONDITION_DRUNKENSTATE:
+        case CONDITION_UNIT_STATE:
+        case CONDITION_MAPID:
+        case CONDITION_AREAID:
+        case CONDITION_CREATURE_TYPE:
+        case CONDITION_LEVEL:
+        case CONDITION_OBJECT_ENTRY_GUID:
+        case CONDITION_TYPE_MASK:
+        case CONDITION_ALIVE:
+        case CONDITION_HP_VAL:
+        case CONDITION_HP_PCT:
+        case CONDITION_STAND_STATE:
+        case CONDITION_CHARMED:
+        case CONDITION_TAXI:
+        case CONDITION_DIFFICULTY_ID:
+            return 0;                                       // fields of the object
+        case CONDITION_ITEM:
+        case CONDITION_NEAR_CREATURE:
+        case CONDITION_NEAR_GAMEOBJECT:
+        case CONDITION_IN_WATER:
+            return 2;                                       // inventory walks, grid searches and map height queries
+        default:
+            return 1;                                       // lookups in auras, quests, spells, reputations...
+    }
+}
+
 uint32 Condition::GetMaxAvailableConditionTargets() const
 {
     // returns number of targets which are available for given source type
@@ -770,7 +812,7 @@ std::string Condition::ToString(bool ext /*= false*/) const
     return ss.str();
 }
 
-ConditionMgr::ConditionMgr() { }
+ConditionMgr::ConditionMgr() : LoadCount(0) { }
 
 ConditionMgr::~ConditionMgr()
 {
@@ -819,28 +861,31 @@ uint32 ConditionMgr::GetSearcherTypeMaskForConditionList(ConditionContainer cons
 
 bool ConditionMgr::IsObjectMeetToConditionList(ConditionSourceInfo& sourceInfo, ConditionContainer const& conditions) const
 {
-    //     groupId, groupCheckPassed
-    std::map<uint32, bool> elseGroupStore;
+    //     groupId, groupCheckPassed - lists rarely use more than a few else groups, keep them on the stack
+    boost::container::small_vector<std::pair<uint32, bool>, 4> elseGroupStore;
     for (Condition const* condition : conditions)
     {
         TC_LOG_DEBUG("condition", "ConditionMgr::IsPlayerMeetToConditionList %s val1: %u", condition->ToString().c_str(), condition->ConditionValue1);
         if (condition->isLoaded())
         {
             //! Find ElseGroup in ElseGroupStore
-            std::map<uint32, bool>::const_iterator itr = elseGroupStore.find(condition->ElseGroup);
+            auto itr = std::find_if(elseGroupStore.begin(), elseGroupStore.end(), [condition](std::pair<uint32, bool> const& elseGroup)
+            {
+                return elseGroup.first == condition->ElseGroup;
+            });
+
             //! If not found, add an entry in the store and set to true (placeholder)
             if (itr == elseGroupStore.end())
-                elseGroupStore[condition->ElseGroup] = true;
-            else if (!(*itr).second) //! If another condition in this group was unmatched before this, don't bother checking (the group is false anyway)
+                itr = elseGroupStore.emplace(elseGroupStore.end(), condition->ElseGroup, true);
+            else if (!itr->second) //! If another condition in this group was unmatched before this, don't bother checking (the group is false anyway)
                 continue;
 
             if (condition->ReferenceId)//handle reference
             {
-                ConditionReferenceContainer::const_iterator ref = ConditionReferenceStore.find(condition->ReferenceId);
-                if (ref != ConditionReferenceStore.end())
+                if (condition->ReferenceConditions)
                 {
-                    if (!IsObjectMeetToConditionList(sourceInfo, ref->second))
-                        elseGroupStore[condition->ElseGroup] = false;
+                    if (!IsObjectMeetToConditionList(sourceInfo, *condition->ReferenceConditions))
+                        itr->second = false;
                 }
                 else
                 {
@@ -852,17 +897,106 @@ bool ConditionMgr::IsObjectMeetToConditionList(ConditionSourceInfo& sourceInfo,
             else //handle normal condition
             {
                 if (!condition->Meets(sourceInfo))
-                    elseGroupStore[condition->ElseGroup] = false;
+                    itr->second = false;
             }
         }
     }
-    for (std::map<uint32, bool>::const_iterator i = elseGroupStore.begin(); i != elseGroupStore.end(); ++i)
-        if (i->second)
+
+    for (std::pair<uint32, bool> const& elseGroup : elseGroupStore)
+        if (elseGroup.second)
             return true;
 
     return false;
 }
 
+void ConditionMgr::AddToConditionList(ConditionContainer& conditions, Condition* cond)
+{
+    // failed spell conditions tell the caster why, keep their database order so the same error is reported
+    if (cond->SourceType == CONDITION_SOURCE_TYPE_SPELL)
+    {
+        conditions.push_back(cond);
+        return;
+    }
+
+    // else groups are evaluated independently of their position, order the list by evaluation cost
+    uint32 cost = cond->GetEvaluationCost();
+    conditions.insert(std::upper_bound(conditions.begin(), conditions.end(), cost, [](uint32 value, Condition const* other)
+    {
+        return value < other->GetEvaluationCost();
+    }), cond);
+}
+
+void ConditionMgr::SortReferenceTemplates()
+{
+    // templates used by spell conditions, directly or through other templates, report their failures
+    // to the caster as well and keep their database order, the other ones are ordered by evaluation cost
+    std::unordered_set<uint32> spellReferences;
+    std::vector<ConditionContainer const*> pending;
+    for (ConditionsByEntryMap::value_type const& conditions : ConditionStore[CONDITION_SOURCE_TYPE_SPELL])
+        pending.push_back(&conditions.second);
+
+    while (!pending.empty())
+    {
+        ConditionContainer const* conditions = pending.back();
+        pending.pop_back();
+
+        for (Condition const* cond : *conditions)
+        {
+            if (!cond->ReferenceId || !spellReferences.insert(cond->ReferenceId).second)
+                continue;
+
+            ConditionReferenceContainer::const_iterator ref = ConditionReferenceStore.find(cond->ReferenceId);
+            if (ref != ConditionReferenceStore.end())
+                pending.push_back(&ref->second);
+        }
+    }
+
+    for (ConditionReferenceContainer::value_type& ref : ConditionReferenceStore)
+    {
+        if (spellReferences.count(ref.first))
+            continue;
+
+        std::stable_sort(ref.second.begin(), ref.second.end(), [](Condition const* left, Condition const* right)
+        {
+            return left->GetEvaluationCost() < right->GetEvaluationCost();
+        });
+    }
+}
+
+void ConditionMgr::ResolveReferences()
+{
+    auto resolve = [this](ConditionContainer const& conditions)
+    {
+        for (Condition* cond : conditions)
+        {
+            if (!cond->ReferenceId)
+                continue;
+
+            ConditionReferenceContainer::const_iterator ref = ConditionReferenceStore.find(cond->ReferenceId);
+            cond->ReferenceConditions = ref != ConditionReferenceStore.end() ? &ref->second : nullptr;
+        }
+    };
+
+    for (ConditionReferenceContainer::value_type const& ref : ConditionReferenceStore)
+        resolve(ref.second);
+
+    for (ConditionsByEntryMap const& conditionsByEntry : ConditionStore)
+        for (ConditionsByEntryMap::value_type const& conditions : conditionsByEntry)
+            resolve(conditions.second);
+
+    for (ConditionEntriesByCreatureIdMap const* store : { &VehicleSpellConditionStore, &SpellClickEventConditionStore, &NpcVendorConditionContainerStore })
+        for (ConditionEntriesByCreatureIdMap::value_type const& conditionsByEntry : *store)
+            for (ConditionsByEntryMap::value_type const& conditions : conditionsByEntry.second)
+                resolve(conditions.second);
+
+    for (SmartEventConditionContainer::value_type const& conditionsByEntry : SmartEventConditionStore)
+        for (ConditionsByEntryMap::value_type const& conditions : conditionsByEntry.second)
+            resolve(conditions.second);
+
+    // grouped conditions live in their owners (loot, gossip, spell effects...), all of them are kept here too
+    resolve(AllocatedMemoryStore);
+}
+
 bool ConditionMgr::IsObjectMeetToConditions(WorldObject* object, ConditionContainer const& conditions) const
 {
     ConditionSourceInfo srcInfo = ConditionSourceInfo(object);
@@ -1006,6 +1140,18 @@ bool ConditionMgr::IsObjectMeetingSmartEventConditions(int64 entryOrGuid, uint32
     return true;
 }
 
+ConditionContainer const* ConditionMgr::GetConditionsForSmartEvent(int64 entryOrGuid, uint32 eventId, uint32 sourceType) const
+{
+    SmartEventConditionContainer::const_iterator itr = SmartEventConditionStore.find(std::make_pair(entryOrGuid, sourceType));
+    if (itr != SmartEventConditionStore.end())
+    {
+        ConditionsByEntryMap::const_iterator i = itr->second.find(eventId + 1);
+        if (i != itr->second.end())
+            return &i->second;
+    }
+    return nullptr;
+}
+
 bool ConditionMgr::IsObjectMeetingVendorItemConditions(uint32 creatureId, uint32 itemId, Player* player, Creature* vendor) const
 {
     ConditionEntriesByCreatureIdMap::const_iterator itr = NpcVendorConditionContainerStore.find(creatureId);
@@ -1033,6 +1179,7 @@ void ConditionMgr::LoadConditions(bool isReload)
     uint32 oldMSTime = getMSTime();
 
     Clean();
+    ++LoadCount;
 
     //must clear all custom handled cases (groupped types) before reload
     if (isReload)
@@ -1136,6 +1283,7 @@ void ConditionMgr::LoadConditions(bool isReload)
 
         if (iSourceTypeOrReferenceId < 0)//it is a reference template
         {
+            // database order until every condition is loaded, SortReferenceTemplates knows which ones spell conditions use
             ConditionReferenceStore[std::abs(iSourceTypeOrReferenceId)].push_back(cond);//add to reference storage
             ++count;
             continue;
@@ -1224,7 +1372,7 @@ void ConditionMgr::LoadConditions(bool isReload)
                     break;
                 case CONDITION_SOURCE_TYPE_SPELL_CLICK_EVENT:
                 {
-                    SpellClickEventConditionStore[cond->SourceGroup][cond->SourceEntry].push_back(cond);
+                    AddToConditionList(SpellClickEventConditionStore[cond->SourceGroup][cond->SourceEntry], cond);
                     valid = true;
                     ++count;
                     continue;   // do not add to m_AllocatedMemory to avoid double deleting
@@ -1234,7 +1382,7 @@ void ConditionMgr::LoadConditions(bool isReload)
                     break;
                 case CONDITION_SOURCE_TYPE_VEHICLE_SPELL:
                 {
-                    VehicleSpellConditionStore[cond->SourceGroup][cond->SourceEntry].push_back(cond);
+                    AddToConditionList(VehicleSpellConditionStore[cond->SourceGroup][cond->SourceEntry], cond);
                     valid = true;
                     ++count;
                     continue;   // do not add to m_AllocatedMemory to avoid double deleting
@@ -1243,14 +1391,14 @@ void ConditionMgr::LoadConditions(bool isReload)
                 {
                     //! TODO: PAIR_32 ?
                     std::pair<int32, uint32> key = std::make_pair(cond->SourceEntry, cond->SourceId);
-                    SmartEventConditionStore[key][cond->SourceGroup].push_back(cond);
+                    AddToConditionList(SmartEventConditionStore[key][cond->SourceGroup], cond);
                     valid = true;
                     ++count;
                     continue;
                 }
                 case CONDITION_SOURCE_TYPE_NPC_VENDOR:
                 {
-                    NpcVendorConditionContainerStore[cond->SourceGroup][cond->SourceEntry].push_back(cond);
+                    AddToConditionList(NpcVendorConditionContainerStore[cond->SourceGroup][cond->SourceEntry], cond);
                     valid = true;
                     ++count;
                     continue;
@@ -1277,11 +1425,14 @@ void ConditionMgr::LoadConditions(bool isReload)
 
         //handle not grouped conditions
         //add new Condition to storage based on Type/Entry
-        ConditionStore[cond->SourceType][cond->SourceEntry].push_back(cond);
+        AddToConditionList(ConditionStore[cond->SourceType][cond->SourceEntry], cond);
         ++count;
     }
     while (result->NextRow());
 
+    SortReferenceTemplates();
+    ResolveReferences();
+
     TC_LOG_INFO("server.loading", ">> Loaded %u conditions in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
 
@@ -1310,7 +1461,7 @@ bool ConditionMgr::addToGossipMenus(Condition* cond) const
         {
             if ((*itr).second.MenuId == cond->SourceGroup && (*itr).second.TextId == uint32(cond->SourceEntry))
             {
-                (*itr).second.Conditions.push_back(cond);
+                AddToConditionList((*itr).second.Conditions, cond);
                 return true;
             }
         }
@@ -1329,7 +1480,7 @@ bool ConditionMgr::addToGossipMenuItems(Condition* cond) const
         {
             if ((*itr).second.MenuId == cond->SourceGroup && (*itr).second.OptionIndex == uint32(cond->SourceEntry))
             {
-                (*itr).second.Conditions.push_back(cond);
+                AddToConditionList((*itr).second.Conditions, cond);
                 return true;
             }
         }
@@ -1436,7 +1587,7 @@ bool ConditionMgr::addToSpellImplicitTargetConditions(Condition* cond) const
                     break;
                 }
             }
-            sharedList->push_back(cond);
+            AddToConditionList(*sharedList, cond);
             break;
         }
     }
@@ -1458,7 +1609,7 @@ bool ConditionMgr::addToPhases(Condition* cond) const
                     {
                         if (phase.PhaseInfo->Id == cond->SourceGroup)
                         {
-                            phase.Conditions.push_back(cond);
+                            AddToConditionList(phase.Conditions, cond);
                             found = true;
                         }
                     }
@@ -1475,7 +1626,7 @@ bool ConditionMgr::addToPhases(Condition* cond) const
         {
             if (phase.PhaseInfo->Id == cond->SourceGroup)
             {
-                phase.Conditions.push_back(cond);
+                AddToConditionList(phase.Conditions, cond);
                 return true;
             }
         }
@@ -221,6 +221,7 @@ struct TC_GAME_API Condition
     uint32                  ScriptId;
     uint8                   ConditionTarget;
     bool                    NegativeCondition;
+    std::vector<Condition*> const* ReferenceConditions; // conditions of ReferenceId, resolved once all conditions are loaded
 
     Condition()
     {
@@ -239,10 +240,12 @@ struct TC_GAME_API Condition
         ErrorTextId        = 0;
         ScriptId           = 0;
         NegativeCondition  = false;
+        ReferenceConditions = nullptr;
     }
 
     bool Meets(ConditionSourceInfo& sourceInfo) const;
     uint32 GetSearcherTypeMaskForCondition() const;
+    uint32 GetEvaluationCost() const;
     bool isLoaded() const { return ConditionType > CONDITION_NONE || ReferenceId; }
     uint32 GetMaxAvailableConditionTargets() const;
 
@@ -272,6 +275,7 @@ class TC_GAME_API ConditionMgr
         bool IsObjectMeetToConditions(WorldObject* object, ConditionContainer const& conditions) const;
         bool IsObjectMeetToConditions(WorldObject* object1, WorldObject* object2, ConditionContainer const& conditions) const;
         bool IsObjectMeetToConditions(ConditionSourceInfo& sourceInfo, ConditionContainer const& conditions) const;
+        static void AddToConditionList(ConditionContainer& conditions, Condition* cond);
         static bool CanHaveSourceGroupSet(ConditionSourceType sourceType);
         static bool CanHaveSourceIdSet(ConditionSourceType sourceType);
         bool IsObjectMeetingNotGroupedConditions(ConditionSourceType sourceType, uint32 entry, ConditionSourceInfo& sourceInfo) const;
@@ -281,10 +285,14 @@ class TC_GAME_API ConditionMgr
         ConditionContainer const* GetConditionsForSpellClickEvent(uint32 creatureId, uint32 spellId) const;
         bool IsObjectMeetingVehicleSpellConditions(uint32 creatureId, uint32 spellId, Player* player, Unit* vehicle) const;
         bool IsObjectMeetingSmartEventConditions(int64 entryOrGuid, uint32 eventId, uint32 sourceType, Unit* unit, WorldObject* baseObject) const;
+        ConditionContainer const* GetConditionsForSmartEvent(int64 entryOrGuid, uint32 eventId, uint32 sourceType) const;
         bool IsObjectMeetingVendorItemConditions(uint32 creatureId, uint32 itemId, Player* player, Creature* vendor) const;
 
         static bool IsPlayerMeetingCondition(Player const* player, PlayerConditionEntry const* condition);
 
+        // incremented on every (re)load, pointers to condition lists taken before a reload are invalid
+        uint32 GetLoadCount() const { return LoadCount; }
+
         struct ConditionTypeInfo
         {
             char const* Name;
@@ -303,6 +311,8 @@ class TC_GAME_API ConditionMgr
         bool addToSpellImplicitTargetConditions(Condition* cond) const;
         bool addToPhases(Condition* cond) const;
         bool IsObjectMeetToConditionList(ConditionSourceInfo& sourceInfo, ConditionContainer const& conditions) const;
+        void SortReferenceTemplates();
+        void ResolveReferences();
 
         static void LogUselessConditionValue(Condition* cond, uint8 index, uint32 value);
 
@@ -315,6 +325,8 @@ class TC_GAME_API ConditionMgr
         ConditionEntriesByCreatureIdMap SpellClickEventConditionStore;
         ConditionEntriesByCreatureIdMap NpcVendorConditionContainerStore;
         SmartEventConditionContainer    SmartEventConditionStore;
+
+        uint32 LoadCount;
 };
 
 #define sConditionMgr ConditionMgr::instance()
@@ -27,7 +27,11 @@
 #include "Timer.h"
 #include "Util.h"
 #include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
 #include <sstream>
+#include <thread>
 #include <cctype>
 
 // temporary hack until includes are sorted out (don't want to pull in Windows.h)
@@ -426,9 +430,22 @@ namespace
 
 typedef std::vector<std::string> DB2StoreProblemList;
 
+// shared by the threads loading stores, every store is loaded by exactly one of them
+struct DB2LoadState
+{
+    DB2LoadState() : AvailableDb2Locales(0xFF) { }
+
+    std::atomic<uint32> AvailableDb2Locales;
+    std::mutex Lock;                                        // guards everything below
+    DB2StoreProblemList Errors;
+    std::vector<std::pair<uint32 /*loadTime*/, std::string /*fileName*/>> LoadTimes;
+};
+
 template<class T, template<class> class DB2>
-inline void LoadDB2(uint32& availableDb2Locales, DB2StoreProblemList& errlist, StorageMap& stores, DB2StorageBase* storage, std::string const& db2Path, uint32 defaultLocale, DB2<T> const& /*hint*/)
+inline void LoadDB2(DB2LoadState& state, StorageMap& stores, DB2StorageBase* storage, std::string const& db2Path, uint32 defaultLocale, DB2<T> const& /*hint*/)
 {
+    uint32 oldMSTime = getMSTime();
+
     // validate structure
     DB2LoadInfo const* loadInfo = storage->GetLoadInfo();
     {
@@ -463,9 +480,9 @@ inline void LoadDB2(uint32& availableDb2Locales, DB2StoreProblemList& errlist, S
             if (defaultLocale == i || i == LOCALE_none)
                 continue;
 
-            if (availableDb2Locales & (1 << i))
+            if (state.AvailableDb2Locales & (1 << i))
                 if (!storage->LoadStringsFrom((db2Path + localeNames[i] + '/'), i))
-                    availableDb2Locales &= ~(1 << i);             // mark as not available for speedup next checks
+                    state.AvailableDb2Locales &= ~(1 << i);       // mark as not available for speedup next checks
 
             storage->LoadStringsFromDB(i);
         }
@@ -479,13 +496,22 @@ inline void LoadDB2(uint32& availableDb2Locales, DB2StoreProblemList& errlist, S
             stream << storage->GetFileName() << " exists, and has " << storage->GetFieldCount() << " field(s) (expected " << loadInfo->Meta->FieldCount
                 << "). Extracted file might be from wrong client version.";
             std::string buf = stream.str();
-            errlist.push_back(buf);
+            std::lock_guard<std::mutex> lock(state.Lock);
+            state.Errors.push_back(buf);
             fclose(f);
         }
         else
-            errlist.push_back(storage->GetFileName());
+        {
+            std::lock_guard<std::mutex> lock(state.Lock);
+            state.Errors.push_back(storage->GetFileName());
+        }
     }
 
+    uint32 loadTime = GetMSTimeDiffToNow(oldMSTime);
+    TC_LOG_DEBUG("server.loading", "Loaded %s in %u ms", storage->GetFileName().c_str(), loadTime);
+
+    std::lock_guard<std::mutex> lock(state.Lock);
+    state.LoadTimes.emplace_back(loadTime, storage->GetFileName());
     stores[storage->GetTableHash()] = storage;
 }
 
@@ -495,16 +521,17 @@ DB2Manager& DB2Manager::Instance()
     return instance;
 }
 
-void DB2Manager::LoadStores(std::string const& dataPath, uint32 defaultLocale)
+void DB2Manager::LoadStores(std::string const& dataPath, uint32 defaultLocale, uint32 threads)
 {
     uint32 oldMSTime = getMSTime();
 
     std::string db2Path = dataPath + "dbc/";
 
-    DB2StoreProblemList bad_db2_files;
-    uint32 availableDb2Locales = 0xFF;
+    DB2LoadState state;
+    std::vector<std::function<void()>> loaders;
 
-#define LOAD_DB2(store) LoadDB2(availableDb2Locales, bad_db2_files, _stores, &store, db2Path, defaultLocale, store)
+    // stores do not depend on each other while loading, only the containers built below need several of them
+#define LOAD_DB2(store) loaders.emplace_back([&]() { LoadDB2(state, _stores, &store, db2Path, defaultLocale, store); })
 
     LOAD_DB2(sAchievementStore);
     LOAD_DB2(sAdventureJournalStore);
@@ -763,6 +790,35 @@ void DB2Manager::LoadStores(std::string const& dataPath, uint32 defaultLocale)
 
 #undef LOAD_DB2
 
+    {
+        std::atomic<std::size_t> nextLoader(0);
+        auto loadStores = [&]()
+        {
+            for (std::size_t i = nextLoader++; i < loaders.size(); i = nextLoader++)
+                loaders[i]();
+        };
+
+        std::vector<std::thread> loadThreads;
+        for (uint32 i = 1; i < threads; ++i)
+            loadThreads.emplace_back(loadStores);
+
+        loadStores();
+
+        for (std::thread& loadThread : loadThreads)
+            loadThread.join();
+    }
+
+    DB2StoreProblemList& bad_db2_files = state.Errors;
+    std::sort(bad_db2_files.begin(), bad_db2_files.end());
+
+    std::sort(state.LoadTimes.begin(), state.LoadTimes.end(), std::greater<std::pair<uint32, std::string>>());
+    std::ostringstream slowestStores;
+    for (std::size_t i = 0; i < std::min<std::size_t>(state.LoadTimes.size(), 10); ++i)
+        slowestStores << (i ? ", " : "") << state.LoadTimes[i].second << " (" << state.LoadTimes[i].first << " ms)";
+
+    TC_LOG_INFO("server.loading", ">> Loaded " SZFMTD " DB2 files using %u thread(s) in %u ms, slowest: %s",
+        loaders.size(), std::max(threads, 1u), GetMSTimeDiffToNow(oldMSTime), slowestStores.str().c_str());
+
     for (AreaGroupMemberEntry const* areaGroupMember : sAreaGroupMemberStore)
         _areaGroupMembers[areaGroupMember->AreaGroupID].push_back(areaGroupMember->AreaID);
 
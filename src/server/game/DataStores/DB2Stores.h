@@ -276,7 +276,7 @@ public:
 
     static DB2Manager& Instance();
 
-    void LoadStores(std::string const& dataPath, uint32 defaultLocale);
+    void LoadStores(std::string const& dataPath, uint32 defaultLocale, uint32 threads);
     DB2StorageBase const* GetStorage(uint32 type) const;
 
     void LoadHotfixData();
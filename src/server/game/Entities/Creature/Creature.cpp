@@ -39,6 +39,7 @@
 #include "MotionMaster.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
+#include "ObjectPool.h"
 #include "PhasingHandler.h"
 #include "Player.h"
 #include "PoolMgr.h"
@@ -189,10 +190,22 @@ bool ForcedDespawnDelayEvent::Execute(uint64 /*e_time*/, uint32 /*p_time*/)
     return true;
 }
 
+// grid unloads hand their blocks to the next grid load on the same map update thread
+// up to 256 free blocks (about 4 MB) stay cached per thread
+void* Creature::operator new(std::size_t size)
+{
+    return Trinity::ObjectPool<Creature, 256>::Allocate(size);
+}
+
+void Creature::operator delete(void* ptr, std::size_t size)
+{
+    Trinity::ObjectPool<Creature, 256>::Deallocate(ptr, size);
+}
+
 Creature::Creature(bool isWorldObject): Unit(isWorldObject), MapObject(),
 m_groupLootTimer(0), m_PlayerDamageReq(0),
 _pickpocketLootRestore(0), m_corpseRemoveTime(0), m_respawnTime(0),
-m_respawnDelay(300), m_corpseDelay(60), m_respawnradius(0.0f), m_boundaryCheckTime(2500), m_combatPulseTime(0), m_combatPulseDelay(0), m_reactState(REACT_AGGRESSIVE),
+m_respawnDelay(300), m_corpseDelay(60), m_respawnradius(0.0f), m_boundaryCheckTime(2500), m_combatPulseTime(0), m_combatPulseDelay(0), m_throttledAIUpdateDiff(0), m_reactState(REACT_AGGRESSIVE),
 m_defaultMovementType(IDLE_MOTION_TYPE), m_spawnId(UI64LIT(0)), m_equipmentId(0), m_originalEquipmentId(0), m_AlreadyCallAssistance(false),
 m_AlreadySearchedAssistance(false), m_regenHealth(true), m_cannotReachTarget(false), m_cannotReachTimer(0), m_AI_locked(false), m_meleeDamageSchoolMask(SPELL_SCHOOL_MASK_NORMAL),
 m_originalEntry(0), m_homePosition(), m_transportHomePosition(), m_creatureInfo(nullptr), m_creatureData(nullptr), m_waypointID(0), m_path_id(0), m_formation(nullptr),
@@ -678,15 +691,25 @@ void Creature::Update(uint32 diff)
 
             if (!IsInEvadeMode() && IsAIEnabled)
             {
-                // do not allow the AI to be changed during update
-                m_AI_locked = true;
-                i_AI->UpdateOperations(diff);
+                // idle creatures far from any player update their AI at a reduced rate, with the accumulated diff
+                // the skipped time is also passed on when the creature wakes up early (aggro, player coming close)
+                uint32 aiDiff = m_throttledAIUpdateDiff + diff;
+                if (aiDiff < sWorld->getIntConfig(CONFIG_CREATURE_AI_UPDATE_LOD_INTERVAL) && CanThrottleAIUpdate())
+                    m_throttledAIUpdateDiff = aiDiff;
+                else
+                {
+                    m_throttledAIUpdateDiff = 0;
+
+                    // do not allow the AI to be changed during update
+                    m_AI_locked = true;
+                    i_AI->UpdateOperations(aiDiff);
 
-                // Recheck in case UpdateOperations changed the AI (creature destroy, etc)
-                if (i_AI)
-                    i_AI->UpdateAI(diff);
+                    // Recheck in case UpdateOperations changed the AI (creature destroy, etc)
+                    if (i_AI)
+                        i_AI->UpdateAI(aiDiff);
 
-                m_AI_locked = false;
+                    m_AI_locked = false;
+                }
             }
 
             // creature can be dead after UpdateAI call
@@ -737,6 +760,26 @@ void Creature::Update(uint32 diff)
     sScriptMgr->OnCreatureUpdate(this, diff);
 }
 
+bool Creature::CanThrottleAIUpdate() const
+{
+    if (sWorld->getFloatConfig(CONFIG_CREATURE_AI_UPDATE_LOD_DISTANCE) <= 0.0f)
+        return false;
+
+    // combat, boss and player controlled creatures always update at full rate
+    if (IsInCombat() || isActiveObject() || isWorldBoss() || IsDungeonBoss() || !GetCharmerOrOwnerGUID().IsEmpty())
+        return false;
+
+    // scripted creatures (core or database AI) only when their AI tells it is idle
+    if ((GetScriptId() || !GetCreatureTemplate()->AIName.empty()) && !AI()->CanThrottleUpdate())
+        return false;
+
+    if (GetMap()->Instanceable())
+        return false;
+
+    // the map marks the cells around its players at the start of each update
+    return !GetMap()->IsCellNearPlayers(Trinity::ComputeCellCoord(GetPositionX(), GetPositionY()).GetId());
+}
+
 void Creature::RegenerateMana()
 {
     uint32 curValue = GetPower(POWER_MANA);
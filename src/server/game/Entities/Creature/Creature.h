@@ -69,6 +69,9 @@ class TC_GAME_API Creature : public Unit, public GridObject<Creature>, public Ma
         explicit Creature(bool isWorldObject = false);
         virtual ~Creature();
 
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
+
         void AddToWorld() override;
         void RemoveFromWorld() override;
 
@@ -385,6 +388,8 @@ class TC_GAME_API Creature : public Unit, public GridObject<Creature>, public Ma
         uint32 m_boundaryCheckTime;                         // (msecs) remaining time for next evade boundary check
         uint32 m_combatPulseTime;                           // (msecs) remaining time for next zone-in-combat pulse
         uint32 m_combatPulseDelay;                          // (secs) how often the creature puts the entire zone in combat (only works in dungeons)
+        uint32 m_throttledAIUpdateDiff;                     // (msecs) time the AI was not updated for while far from players
+        bool CanThrottleAIUpdate() const;
 
         ReactStates m_reactState;                           // for AI, not charmInfo
         void RegenerateMana();
@@ -34,6 +34,7 @@
 #include "MiscPackets.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
+#include "ObjectPool.h"
 #include "OutdoorPvPMgr.h"
 #include "PhasingHandler.h"
 #include "PoolMgr.h"
@@ -55,6 +56,17 @@ QuaternionData QuaternionData::fromEulerAnglesZYX(float Z, float Y, float X)
     return QuaternionData(quat.x, quat.y, quat.z, quat.w);
 }
 
+// shares the recycling scheme of Creature, up to 256 free blocks (about 600 KB) stay cached per thread
+void* GameObject::operator new(std::size_t size)
+{
+    return Trinity::ObjectPool<GameObject, 256>::Allocate(size);
+}
+
+void GameObject::operator delete(void* ptr, std::size_t size)
+{
+    Trinity::ObjectPool<GameObject, 256>::Deallocate(ptr, size);
+}
+
 GameObject::GameObject() : WorldObject(false), MapObject(),
     m_model(nullptr), m_goValue(), m_AI(nullptr), _animKitId(0),
     _worldEffectID(0), _scheduler(this)
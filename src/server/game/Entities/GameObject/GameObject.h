@@ -86,6 +86,9 @@ class TC_GAME_API GameObject : public WorldObject, public GridObject<GameObject>
         explicit GameObject();
         ~GameObject();
 
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
+
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const override;
 
         void AddToWorld() override;
@@ -53,6 +53,8 @@
 #include "World.h"
 #include "WorldSession.h"
 #include <G3D/Vector3.h>
+#include <array>
+#include <vector>
 
 constexpr float VisibilityDistances[AsUnderlyingType(VisibilityDistanceType::Max)] =
 {
@@ -3063,6 +3065,30 @@ float WorldObject::GetObjectSize() const
     return (m_valuesCount > UNIT_FIELD_COMBATREACH) ? m_floatValues[UNIT_FIELD_COMBATREACH] : DEFAULT_WORLD_OBJECT_SIZE;
 }
 
+// ground (searched from MAX_HEIGHT) and floor (searched from floorZ) of count points with one Map::GetHeights call
+static void GetGroundAndFloorHeights(WorldObject const* obj, float const* x, float const* y, std::size_t count, float floorZ, float* ground, float* floor)
+{
+    // both probes of a point are next to each other so they share a terrain and vmap batch
+    std::vector<float> pointX(count * 2), pointY(count * 2), pointZ(count * 2), heights(count * 2);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        pointX[i * 2] = pointX[i * 2 + 1] = x[i];
+        pointY[i * 2] = pointY[i * 2 + 1] = y[i];
+        pointZ[i * 2] = MAX_HEIGHT;
+        pointZ[i * 2 + 1] = floorZ;
+    }
+
+    obj->GetMap()->GetHeights(obj->GetPhaseShift(), pointX.data(), pointY.data(), pointZ.data(), heights.data(), count * 2, true);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        ground[i] = heights[i * 2];
+        floor[i] = heights[i * 2 + 1];
+    }
+}
+
+// the destination is probed alone, when it is too far above or below pos the 9 points stepping back towards pos are probed in one batch
+static uint32 const MovePositionSteps = 10;
+
 void WorldObject::MovePosition(Position &pos, float dist, float angle)
 {
     angle += GetOrientation();
@@ -3078,28 +3104,34 @@ void WorldObject::MovePosition(Position &pos, float dist, float angle)
         return;
     }
 
-    ground = GetMap()->GetHeight(GetPhaseShift(), destx, desty, MAX_HEIGHT, true);
-    floor = GetMap()->GetHeight(GetPhaseShift(), destx, desty, pos.m_positionZ, true);
+    GetGroundAndFloorHeights(this, &destx, &desty, 1, pos.m_positionZ, &ground, &floor);
     destz = std::fabs(ground - pos.m_positionZ) <= std::fabs(floor - pos.m_positionZ) ? ground : floor;
 
-    float step = dist/10.0f;
-
-    for (uint8 j = 0; j < 10; ++j)
+    // do not allow too big z changes
+    if (std::fabs(pos.m_positionZ - destz) <= 6)
+        pos.Relocate(destx, desty, destz);
+    else
     {
-        // do not allow too big z changes
-        if (std::fabs(pos.m_positionZ - destz) > 6)
+        float step = dist / MovePositionSteps;
+        std::array<float, MovePositionSteps - 1> stepX, stepY, stepGround, stepFloor;
+        for (uint32 j = 0; j < stepX.size(); ++j)
         {
             destx -= step * std::cos(angle);
             desty -= step * std::sin(angle);
-            ground = GetMap()->GetHeight(GetPhaseShift(), destx, desty, MAX_HEIGHT, true);
-            floor = GetMap()->GetHeight(GetPhaseShift(), destx, desty, pos.m_positionZ, true);
-            destz = std::fabs(ground - pos.m_positionZ) <= std::fabs(floor - pos.m_positionZ) ? ground : floor;
+            stepX[j] = destx;
+            stepY[j] = desty;
         }
-        // we have correct destz now
-        else
+
+        GetGroundAndFloorHeights(this, stepX.data(), stepY.data(), stepX.size(), pos.m_positionZ, stepGround.data(), stepFloor.data());
+        for (uint32 j = 0; j < stepX.size(); ++j)
         {
-            pos.Relocate(destx, desty, destz);
-            break;
+            destz = std::fabs(stepGround[j] - pos.m_positionZ) <= std::fabs(stepFloor[j] - pos.m_positionZ) ? stepGround[j] : stepFloor[j];
+            // we have correct destz now
+            if (std::fabs(pos.m_positionZ - destz) <= 6)
+            {
+                pos.Relocate(stepX[j], stepY[j], destz);
+                break;
+            }
         }
     }
 
@@ -3110,10 +3142,8 @@ void WorldObject::MovePosition(Position &pos, float dist, float angle)
 }
 
 // @todo: replace with WorldObject::UpdateAllowedPositionZ
-float NormalizeZforCollision(WorldObject* obj, float x, float y, float z)
+float NormalizeZforCollision(WorldObject* obj, float x, float y, float z, float ground, float floor)
 {
-    float ground = obj->GetMap()->GetHeight(obj->GetPhaseShift(), x, y, MAX_HEIGHT, true);
-    float floor = obj->GetMap()->GetHeight(obj->GetPhaseShift(), x, y, z + 2.0f, true);
     float helper = std::fabs(ground - z) <= std::fabs(floor - z) ? ground : floor;
     if (z > helper) // must be above ground
     {
@@ -3135,6 +3165,13 @@ float NormalizeZforCollision(WorldObject* obj, float x, float y, float z)
     return helper;
 }
 
+float NormalizeZforCollision(WorldObject* obj, float x, float y, float z)
+{
+    float ground, floor;
+    GetGroundAndFloorHeights(obj, &x, &y, 1, z + 2.0f, &ground, &floor);
+    return NormalizeZforCollision(obj, x, y, z, ground, floor);
+}
+
 void WorldObject::MovePositionToFirstCollision(Position &pos, float dist, float angle)
 {
     angle += GetOrientation();
@@ -3173,22 +3210,43 @@ void WorldObject::MovePositionToFirstCollision(Position &pos, float dist, float
         dist = std::sqrt((pos.m_positionX - destx)*(pos.m_positionX - destx) + (pos.m_positionY - desty)*(pos.m_positionY - desty));
     }
 
-    float step = dist / 10.0f;
-
-    for (uint8 j = 0; j < 10; ++j)
+    // do not allow too big z changes
+    if (std::fabs(pos.m_positionZ - destz) <= 6.0f)
+        pos.Relocate(destx, desty, destz);
+    else
     {
-        // do not allow too big z changes
-        if (std::fabs(pos.m_positionZ - destz) > 6.0f)
+        float step = dist / MovePositionSteps;
+        std::array<float, MovePositionSteps - 1> stepX, stepY, stepGround, stepFloor;
+        for (uint32 j = 0; j < stepX.size(); ++j)
         {
             destx -= step * std::cos(angle);
             desty -= step * std::sin(angle);
-            destz = NormalizeZforCollision(this, destx, desty, pos.GetPositionZ());
+            stepX[j] = destx;
+            stepY[j] = desty;
         }
-        // we have correct destz now
-        else
+
+        // every point starts from the same z, so its ground and floor are fetched for all of them at once
+        GetGroundAndFloorHeights(this, stepX.data(), stepY.data(), stepX.size(), pos.GetPositionZ() + 2.0f, stepGround.data(), stepFloor.data());
+        bool found = false;
+        for (uint32 j = 0; j < stepX.size(); ++j)
         {
-            pos.Relocate(destx, desty, destz);
-            break;
+            destz = NormalizeZforCollision(this, stepX[j], stepY[j], pos.GetPositionZ(), stepGround[j], stepFloor[j]);
+            // we have correct destz now
+            if (std::fabs(pos.m_positionZ - destz) <= 6.0f)
+            {
+                pos.Relocate(stepX[j], stepY[j], destz);
+                destx = stepX[j];
+                desty = stepY[j];
+                found = true;
+                break;
+            }
+        }
+
+        // no point was close enough, like before the last step back is kept for the z below
+        if (!found)
+        {
+            destx -= step * std::cos(angle);
+            desty -= step * std::sin(angle);
         }
     }
 
@@ -22544,6 +22544,36 @@ bool Player::IsAffectedBySpellmod(SpellInfo const* spellInfo, SpellModifier* mod
     return spellInfo->IsAffectedBySpellMod(mod);
 }
 
+SpellModifierCacheEntry const& Player::GetSpellModCacheEntry(SpellInfo const* spellInfo, SpellModOp op) const
+{
+    auto itr = m_spellModCache[op].find(spellInfo->Id);
+    if (itr != m_spellModCache[op].end())
+        return itr->second;
+
+    SpellModifierCacheEntry& entry = m_spellModCache[op][spellInfo->Id];
+
+    // everything IsAffectedBySpellmod checks except charges depends only on the spell and the modifier
+    for (SpellModifier* mod : m_spellMods[op][SPELLMOD_FLAT])
+    {
+        if (!IsAffectedBySpellmod(spellInfo, mod))
+            continue;
+
+        entry.FlatMods.push_back(mod);
+        entry.FlatTotal += mod->value;
+    }
+
+    for (SpellModifier* mod : m_spellMods[op][SPELLMOD_PCT])
+    {
+        if (!IsAffectedBySpellmod(spellInfo, mod))
+            continue;
+
+        entry.PctMods.push_back(mod);
+        entry.PctTotal *= 1.0f + CalculatePct(1.0f, mod->value);
+    }
+
+    return entry;
+}
+
 template <class T>
 void Player::ApplySpellMod(uint32 spellId, SpellModOp op, T& basevalue, Spell* spell /*= nullptr*/) const
 {
@@ -22551,6 +22581,10 @@ void Player::ApplySpellMod(uint32 spellId, SpellModOp op, T& basevalue, Spell* s
     if (!spellInfo)
         return;
 
+    SpellModifierCacheEntry const& modCache = GetSpellModCacheEntry(spellInfo, op);
+    if (modCache.FlatMods.empty() && modCache.PctMods.empty())
+        return;
+
     float totalmul = 1.0f;
     int32 totalflat = 0;
 
@@ -22564,7 +22598,7 @@ void Player::ApplySpellMod(uint32 spellId, SpellModOp op, T& basevalue, Spell* s
         case SPELLMOD_CASTING_TIME:
         {
             SpellModifier* modInstantSpell = nullptr;
-            for (SpellModifier* mod : m_spellMods[op][SPELLMOD_PCT])
+            for (SpellModifier* mod : modCache.PctMods)
             {
                 if (!IsAffectedBySpellmod(spellInfo, mod, spell))
                     continue;
@@ -22588,7 +22622,7 @@ void Player::ApplySpellMod(uint32 spellId, SpellModOp op, T& basevalue, Spell* s
         case SPELLMOD_CRITICAL_CHANCE:
         {
             SpellModifier* modCritical = nullptr;
-            for (SpellModifier* mod : m_spellMods[op][SPELLMOD_FLAT])
+            for (SpellModifier* mod : modCache.FlatMods)
             {
                 if (!IsAffectedBySpellmod(spellInfo, mod, spell))
                     continue;
@@ -22609,10 +22643,31 @@ void Player::ApplySpellMod(uint32 spellId, SpellModOp op, T& basevalue, Spell* s
             break;
         }
         default:
+        {
+            // without charged mods every cached mod applies, use the precomputed totals
+            // charges are not cached, auras start and stop using them without touching the modifiers
+            auto usesCharges = [](SpellModifier const* mod) { return mod->ownerAura && mod->ownerAura->IsUsingCharges(); };
+            if (std::none_of(modCache.FlatMods.begin(), modCache.FlatMods.end(), usesCharges) &&
+                std::none_of(modCache.PctMods.begin(), modCache.PctMods.end(), usesCharges))
+            {
+                if (spell)
+                {
+                    for (SpellModifier* mod : modCache.FlatMods)
+                        Player::ApplyModToSpell(mod, spell);
+
+                    if (basevalue + modCache.FlatTotal != T(0))
+                        for (SpellModifier* mod : modCache.PctMods)
+                            Player::ApplyModToSpell(mod, spell);
+                }
+
+                basevalue = T(float(basevalue + modCache.FlatTotal) * modCache.PctTotal);
+                return;
+            }
             break;
+        }
     }
 
-    for (SpellModifier* mod : m_spellMods[op][SPELLMOD_FLAT])
+    for (SpellModifier* mod : modCache.FlatMods)
     {
         if (!IsAffectedBySpellmod(spellInfo, mod, spell))
             continue;
@@ -22621,7 +22676,7 @@ void Player::ApplySpellMod(uint32 spellId, SpellModOp op, T& basevalue, Spell* s
         Player::ApplyModToSpell(mod, spell);
     }
 
-    for (SpellModifier* mod : m_spellMods[op][SPELLMOD_PCT])
+    for (SpellModifier* mod : modCache.PctMods)
     {
         if (!IsAffectedBySpellmod(spellInfo, mod, spell))
             continue;
@@ -22658,6 +22713,8 @@ void Player::AddSpellMod(SpellModifier* mod, bool apply)
     else
         m_spellMods[mod->op][mod->type].erase(mod);
 
+    m_spellModCache[mod->op].clear();
+
     /// Now, send spellmodifier packet
     if (!IsLoading())
     {
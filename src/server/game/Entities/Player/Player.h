@@ -235,6 +235,17 @@ struct SpellModifier
     Aura* const ownerAura;
 };
 
+// Modifiers of a single SpellModOp that affect a single spell, rebuilt whenever modifiers of that op change
+struct SpellModifierCacheEntry
+{
+    SpellModifierCacheEntry() : FlatTotal(0), PctTotal(1.0f) { }
+
+    std::vector<SpellModifier*> FlatMods;
+    std::vector<SpellModifier*> PctMods;
+    int32 FlatTotal;
+    float PctTotal;                                         // totals are only usable while no mod uses charges, checked per call
+};
+
 enum PlayerCurrencyState
 {
     PLAYERCURRENCY_UNCHANGED = 0,
@@ -256,6 +267,7 @@ struct PlayerCurrency
 typedef std::unordered_map<uint32, PlayerSpellState> PlayerTalentMap;
 typedef std::unordered_map<uint32, PlayerSpell*> PlayerSpellMap;
 typedef std::unordered_set<SpellModifier*> SpellModContainer;
+typedef std::unordered_map<uint32 /*spellId*/, SpellModifierCacheEntry> SpellModCacheContainer;
 typedef std::unordered_map<uint32, PlayerCurrency> PlayerCurrenciesMap;
 
 typedef std::unordered_map<uint32 /*instanceId*/, time_t/*releaseTime*/> InstanceTimeMap;
@@ -1747,6 +1759,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         static bool IsAffectedBySpellmod(SpellInfo const* spellInfo, SpellModifier* mod, Spell* spell = nullptr);
         template <class T>
         void ApplySpellMod(uint32 spellId, SpellModOp op, T& basevalue, Spell* spell = nullptr) const;
+        SpellModifierCacheEntry const& GetSpellModCacheEntry(SpellInfo const* spellInfo, SpellModOp op) const;
         static void ApplyModToSpell(SpellModifier* mod, Spell* spell);
         void SetSpellModTakingSpell(Spell* spell, bool apply);
         void SendSpellModifiers() const;
@@ -2719,6 +2732,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         int32 m_spellPenetrationItemMod;
 
         SpellModContainer m_spellMods[MAX_SPELLMOD][SPELLMOD_END];
+        mutable SpellModCacheContainer m_spellModCache[MAX_SPELLMOD];
 
         EnchantDurationList m_enchantDuration;
         ItemDurationList m_itemDuration;
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CollisionCache.h"
+#include "Hash.h"
+#include "IVMapManager.h"
+#include "Timer.h"
+#include <cmath>
+
+namespace
+{
+    int32 Quantize(float value)
+    {
+        return int32(std::lround(value * CollisionCache::PositionScale));
+    }
+
+    // returns the slot of key, with found set if it holds a result still valid
+    template<class EntryType, class Key>
+    EntryType& GetSlot(std::vector<EntryType>& table, Key const& key, uint32 now, uint32 generation, bool& found)
+    {
+        if (table.empty())
+            table.resize(CollisionCache::Size);
+
+        std::size_t hash = 0;
+        for (int32 value : key)
+            Trinity::hash_combine(hash, value);
+
+        EntryType& entry = table[hash & (CollisionCache::Size - 1)];
+        found = entry.Used && entry.Key == key && entry.Generation == generation && getMSTimeDiff(entry.Time, now) < CollisionCache::Lifetime;
+        return entry;
+    }
+
+    template<class EntryType, class Key, class Result>
+    void Store(EntryType& entry, Key const& key, uint32 now, uint32 generation, Result value)
+    {
+        entry.Key = key;
+        entry.Time = now;
+        entry.Generation = generation;
+        entry.Value = value;
+        entry.Used = true;
+    }
+}
+
+bool CollisionCache::IsInLineOfSight(VMAP::IVMapManager* vmgr, uint32 terrainMapId, float x1, float y1, float z1, float x2, float y2, float z2, VMAP::ModelIgnoreFlags ignoreFlags)
+{
+    std::array<int32, 8> key = { { Quantize(x1), Quantize(y1), Quantize(z1), Quantize(x2), Quantize(y2), Quantize(z2), int32(terrainMapId), int32(ignoreFlags) } };
+
+    // read before the ray cast, tiles loaded meanwhile must not be hidden behind this result
+    uint32 generation = vmgr->getTileGeneration();
+    uint32 now = getMSTime();
+    bool found;
+    LineOfSightEntry& entry = GetSlot(_lineOfSight, key, now, generation, found);
+    if (found)
+        return entry.Value;
+
+    bool result = vmgr->isInLineOfSight(terrainMapId, x1, y1, z1, x2, y2, z2, ignoreFlags);
+    Store(entry, key, now, generation, result);
+    return result;
+}
+
+float CollisionCache::GetHeight(VMAP::IVMapManager* vmgr, uint32 terrainMapId, float x, float y, float z, float maxSearchDist)
+{
+    std::array<int32, 5> key = { { Quantize(x), Quantize(y), Quantize(z), Quantize(maxSearchDist), int32(terrainMapId) } };
+
+    uint32 generation = vmgr->getTileGeneration();
+    uint32 now = getMSTime();
+    bool found;
+    HeightEntry& entry = GetSlot(_heights, key, now, generation, found);
+    if (found)
+        return entry.Value;
+
+    float result = vmgr->getHeight(terrainMapId, x, y, z, maxSearchDist);
+    Store(entry, key, now, generation, result);
+    return result;
+}
+
+void CollisionCache::GetHeights(VMAP::IVMapManager* vmgr, uint32 terrainMapId, float const* x, float const* y, float const* z, float* heights, std::size_t count, float maxSearchDist)
+{
+    uint32 generation = vmgr->getTileGeneration();
+    uint32 now = getMSTime();
+
+    std::vector<std::size_t> missing;
+    std::vector<float> missingX, missingY, missingZ;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::array<int32, 5> key = { { Quantize(x[i]), Quantize(y[i]), Quantize(z[i]), Quantize(maxSearchDist), int32(terrainMapId) } };
+        bool found;
+        HeightEntry& entry = GetSlot(_heights, key, now, generation, found);
+        if (found)
+        {
+            heights[i] = entry.Value;
+            continue;
+        }
+
+        missing.push_back(i);
+        missingX.push_back(x[i]);
+        missingY.push_back(y[i]);
+        missingZ.push_back(z[i]);
+    }
+
+    if (missing.empty())
+        return;
+
+    std::vector<float> results(missing.size());
+    vmgr->getHeights(terrainMapId, missingX.data(), missingY.data(), missingZ.data(), results.data(), missing.size(), maxSearchDist);
+    for (std::size_t j = 0; j < missing.size(); ++j)
+    {
+        std::size_t i = missing[j];
+        std::array<int32, 5> key = { { Quantize(x[i]), Quantize(y[i]), Quantize(z[i]), Quantize(maxSearchDist), int32(terrainMapId) } };
+        bool found;
+        Store(GetSlot(_heights, key, now, generation, found), key, now, generation, results[j]);
+        heights[i] = results[j];
+    }
+}
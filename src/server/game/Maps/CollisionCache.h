@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_COLLISIONCACHE_H
+#define TRINITY_COLLISIONCACHE_H
+
+#include "Define.h"
+#include "ModelIgnoreFlags.h"
+#include <array>
+#include <vector>
+
+namespace VMAP
+{
+    class IVMapManager;
+}
+
+/*
+ * Recent vmap line of sight and height results of a map, positions rounded to 1/PositionScale yards.
+ * Spells check line of sight between the same caster and targets for every effect, and units around
+ * the same spot probe the same heights, repeated queries within Lifetime ms skip the model ray casts.
+ * Results are dropped as soon as any vmap tile is loaded or unloaded. Only static models are cached,
+ * gameobject models (the dynamic tree) are always checked by the caller.
+ * Tables are direct mapped, a new result replaces the one stored in its slot.
+ * Owned by a map and only used from its update thread.
+ */
+class TC_GAME_API CollisionCache
+{
+public:
+    static uint32 const PositionScale = 4;
+    static uint32 const Size = 2048;                        // entries per table, power of two
+    static uint32 const Lifetime = 1000;                    // ms
+
+    bool IsInLineOfSight(VMAP::IVMapManager* vmgr, uint32 terrainMapId, float x1, float y1, float z1, float x2, float y2, float z2, VMAP::ModelIgnoreFlags ignoreFlags);
+    float GetHeight(VMAP::IVMapManager* vmgr, uint32 terrainMapId, float x, float y, float z, float maxSearchDist);
+    // GetHeight for count points, the points missing from the cache are passed to the vmap manager in one call
+    void GetHeights(VMAP::IVMapManager* vmgr, uint32 terrainMapId, float const* x, float const* y, float const* z, float* heights, std::size_t count, float maxSearchDist);
+
+private:
+    template<std::size_t KeySize, class Result>
+    struct Entry
+    {
+        Entry() : Key(), Time(0), Generation(0), Value(), Used(false) { }
+
+        std::array<int32, KeySize> Key;
+        uint32 Time;
+        uint32 Generation;
+        Result Value;
+        bool Used;
+    };
+
+    typedef Entry<8, bool> LineOfSightEntry;
+    typedef Entry<5, float> HeightEntry;
+
+    std::vector<LineOfSightEntry> _lineOfSight;             // allocated on first use, most instances never need them
+    std::vector<HeightEntry> _heights;
+};
+
+#endif // TRINITY_COLLISIONCACHE_H
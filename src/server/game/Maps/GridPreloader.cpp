@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GridPreloader.h"
+#include "DisableMgr.h"
+#include "Log.h"
+#include "MMapManager.h"
+#include "StringFormat.h"
+#include "Timer.h"
+#include "VMapFactory.h"
+#include "VMapManager2.h"
+#include <cstdio>
+
+namespace
+{
+    // reads the whole file so the map thread finds its pages in the page cache
+    void WarmFile(std::string const& fileName)
+    {
+        FILE* file = fopen(fileName.c_str(), "rb");
+        if (!file)
+            return;
+
+        char buffer[64 * 1024];
+        while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer)) { }
+
+        fclose(file);
+    }
+}
+
+void GridPreloader::Activate(std::size_t threadCount, std::string const& dataPath)
+{
+    _dataPath = dataPath;
+    _vmapManager = dynamic_cast<VMAP::VMapManager2*>(VMAP::VMapFactory::createOrGetVMapManager());
+
+    for (std::size_t i = 0; i < threadCount; ++i)
+        _workerThreads.push_back(std::thread(&GridPreloader::WorkerThread, this));
+}
+
+void GridPreloader::Deactivate()
+{
+    _cancelationToken = true;
+
+    _queue.Cancel();
+
+    for (std::thread& thread : _workerThreads)
+        thread.join();
+
+    _workerThreads.clear();
+
+    for (auto& preload : _preloads)
+        ReleaseModels(preload.second);
+
+    _preloads.clear();
+}
+
+void GridPreloader::Preload(uint32 mapId, uint32 gx, uint32 gy)
+{
+    if (!IsActive())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (!_preloads.emplace(MakeKey(mapId, gx, gy), Preloaded(getMSTime())).second)
+            return;
+    }
+
+    _queue.Push(new Request{ mapId, gx, gy });
+}
+
+void GridPreloader::Update()
+{
+    uint32 now = getMSTime();
+
+    std::lock_guard<std::mutex> lock(_lock);
+    for (auto itr = _preloads.begin(); itr != _preloads.end();)
+    {
+        if (!itr->second.Done || getMSTimeDiff(itr->second.Time, now) < HoldTime)
+        {
+            ++itr;
+            continue;
+        }
+
+        ReleaseModels(itr->second);
+        itr = _preloads.erase(itr);
+    }
+}
+
+void GridPreloader::WorkerThread()
+{
+    while (true)
+    {
+        Request* request = nullptr;
+
+        _queue.WaitAndPop(request);
+
+        if (_cancelationToken || !request)
+        {
+            delete request;
+            return;
+        }
+
+        std::vector<std::string> models;
+        Load(*request, models);
+
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            Preloaded& preloaded = _preloads.at(MakeKey(request->MapId, request->X, request->Y));
+            preloaded.Time = getMSTime();
+            preloaded.Done = true;
+            preloaded.Models = std::move(models);
+        }
+
+        delete request;
+    }
+}
+
+void GridPreloader::Load(Request const& request, std::vector<std::string>& models) const
+{
+    TC_LOG_DEBUG("maps", "GridPreloader: preloading map %u grid [%u, %u]", request.MapId, request.X, request.Y);
+
+    WarmFile(Trinity::StringFormat("%smaps/%04u_%02u_%02u.map", _dataPath.c_str(), request.MapId, request.X, request.Y));
+
+    if (_vmapManager)
+        _vmapManager->preloadMapTileModels((_dataPath + "vmaps").c_str(), request.MapId, request.X, request.Y, models);
+
+    if (DisableMgr::IsPathfindingEnabled(request.MapId))
+        WarmFile(MMAP::MMapManager::getTileFileName(_dataPath, request.MapId, request.X, request.Y));
+}
+
+void GridPreloader::ReleaseModels(Preloaded& preloaded) const
+{
+    for (std::string const& model : preloaded.Models)
+        _vmapManager->releaseModelInstance(model);
+
+    preloaded.Models.clear();
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_GRIDPRELOADER_H
+#define TRINITY_GRIDPRELOADER_H
+
+#include "Define.h"
+#include "ProducerConsumerQueue.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace VMAP
+{
+    class VMapManager2;
+}
+
+/*
+ * Loads the data of grids players are heading to on background threads, so Map::EnsureGridCreated
+ * finds it in memory instead of stalling the map update on disk reads and model parsing.
+ * The vmap models spawned on the grid are acquired (parsed once and shared by every map using them) and
+ * held for HoldTime ms, terrain and navmesh tile files are read once to bring them into the page cache.
+ * Tiles themselves are still added by the map thread, trees and navmeshes are not safe to modify concurrently.
+ */
+class TC_GAME_API GridPreloader
+{
+public:
+    static uint32 const HoldTime = 60000;                   // ms
+
+    GridPreloader() : _cancelationToken(false), _vmapManager(nullptr) { }
+
+    void Activate(std::size_t threadCount, std::string const& dataPath);
+    void Deactivate();
+    bool IsActive() const { return !_workerThreads.empty(); }
+
+    // queues the files of grid [gx, gy] (file coordinates) of a terrain map, called from map threads
+    void Preload(uint32 mapId, uint32 gx, uint32 gy);
+
+    // gives back the models of preloads older than HoldTime, the maps loading their grids hold their own references
+    void Update();
+
+private:
+    struct Request
+    {
+        uint32 MapId;
+        uint32 X;
+        uint32 Y;
+    };
+
+    struct Preloaded
+    {
+        explicit Preloaded(uint32 time) : Time(time), Done(false) { }
+
+        uint32 Time;
+        bool Done;
+        std::vector<std::string> Models;
+    };
+
+    static uint64 MakeKey(uint32 mapId, uint32 gx, uint32 gy) { return (uint64(mapId) << 16) | (gx << 8) | gy; }
+
+    void WorkerThread();
+    void Load(Request const& request, std::vector<std::string>& models) const;
+    void ReleaseModels(Preloaded& preloaded) const;
+
+    ProducerConsumerQueue<Request*> _queue;
+    std::vector<std::thread> _workerThreads;
+    std::atomic<bool> _cancelationToken;
+
+    std::string _dataPath;
+    VMAP::VMapManager2* _vmapManager;
+
+    std::mutex _lock;
+    std::unordered_map<uint64, Preloaded> _preloads;       // queued, being loaded or held
+};
+
+#endif // TRINITY_GRIDPRELOADER_H
@@ -19,6 +19,7 @@
 #include "Map.h"
 #include "Battleground.h"
 #include "CellImpl.h"
+#include "CollisionCache.h"
 #include "Conversation.h"
 #include "DatabaseEnv.h"
 #include "DisableMgr.h"
@@ -37,9 +38,11 @@
 #include "MiscPackets.h"
 #include "MMapFactory.h"
 #include "MotionMaster.h"
+#include "MoveSpline.h"
 #include "ObjectAccessor.h"
 #include "ObjectGridLoader.h"
 #include "ObjectMgr.h"
+#include "PathCache.h"
 #include "Pet.h"
 #include "SceneObject.h"
 #include "PhasingHandler.h"
@@ -51,6 +54,10 @@
 #include "WeatherMgr.h"
 #include "World.h"
 #include "WorldSession.h"
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstring>
 
 u_map_magic MapMagic        = { {'M','A','P','S'} };
 u_map_magic MapVersionMagic = { {'v','1','.','9'} };
@@ -278,7 +285,8 @@ m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
 m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
 m_activeNonPlayersIter(m_activeNonPlayers.end()), _transportsUpdateIter(_transports.end()),
 i_gridExpiry(expiry),
-i_scriptLock(false), _defaultLight(DB2Manager::GetDefaultMapLight(id))
+i_scriptLock(false), _defaultLight(DB2Manager::GetDefaultMapLight(id)), _pathCache(Trinity::make_unique<PathCache>()),
+_collisionCache(Trinity::make_unique<CollisionCache>())
 {
     if (_parent)
     {
@@ -552,6 +560,47 @@ void Map::EnsureGridLoadedForActiveObject(const Cell &cell, WorldObject* object)
     }
 }
 
+// Queues the grids coming into sight along the player's way over the next CONFIG_GRID_PRELOAD_LOOKAHEAD ms
+void Map::PreloadGridsAhead(Player const* player)
+{
+    GridPreloader& preloader = sMapMgr->GetGridPreloader();
+    if (!preloader.IsActive() || (!player->isMoving() && player->movespline->Finalized()))
+        return;
+
+    UnitMoveType moveType = MOVE_RUN;
+    if (player->IsInFlight() || player->IsFlying())
+        moveType = MOVE_FLIGHT;
+    else if (player->IsInWater())
+        moveType = MOVE_SWIM;
+
+    float distance = player->GetSpeed(moveType) * sWorld->getIntConfig(CONFIG_GRID_PRELOAD_LOOKAHEAD) / float(IN_MILLISECONDS);
+    float radius = GetVisibilityRange();
+    float step = SIZE_OF_GRIDS / 2;
+    uint32 steps = uint32(std::ceil(distance / step));
+
+    for (uint32 i = 1; i <= steps; ++i)
+    {
+        float travelled = std::min(i * step, distance);
+        float x = player->GetPositionX() + travelled * std::cos(player->GetOrientation());
+        float y = player->GetPositionY() + travelled * std::sin(player->GetOrientation());
+        if (!Trinity::IsValidMapCoord(x, y))
+            break;
+
+        GridCoord low = Trinity::ComputeGridCoord(x - radius, y - radius);
+        GridCoord high = Trinity::ComputeGridCoord(x + radius, y + radius);
+        for (uint32 gridX = std::max<int32>(int32(low.x_coord), 0); gridX <= std::min<uint32>(high.x_coord, MAX_NUMBER_OF_GRIDS - 1); ++gridX)
+        {
+            for (uint32 gridY = std::max<int32>(int32(low.y_coord), 0); gridY <= std::min<uint32>(high.y_coord, MAX_NUMBER_OF_GRIDS - 1); ++gridY)
+            {
+                uint32 gx = (MAX_NUMBER_OF_GRIDS - 1) - gridX;
+                uint32 gy = (MAX_NUMBER_OF_GRIDS - 1) - gridY;
+                if (!m_parentTerrainMap->GridMaps[gx][gy])
+                    preloader.Preload(m_parentTerrainMap->GetId(), gx, gy);
+            }
+        }
+    }
+}
+
 //Create NGrid and load the object data in it
 bool Map::EnsureGridLoaded(const Cell &cell)
 {
@@ -752,9 +801,41 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::Obj
     }
 }
 
+void Map::MarkCellsNearPlayers(float distance)
+{
+    m_cellsNearPlayers.reset();
+
+    auto markCellsAround = [this, distance](WorldObject const* obj)
+    {
+        if (!obj->IsPositionValid())
+            return;
+
+        CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), distance);
+        for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+            for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+                m_cellsNearPlayers.set((y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x);
+    };
+
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* player = itr->GetSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        markCellsAround(player);
+        if (WorldObject* viewPoint = player->GetViewpoint())
+            markCellsAround(viewPoint);
+    }
+}
+
 void Map::Update(const uint32 t_diff)
 {
     _dynamicTree.update(t_diff);
+
+    // the navmesh is only touched by the map owning the terrain, maps that went quiet give back their idle tiles here
+    if (m_parentTerrainMap == this)
+        MMAP::MMapFactory::createOrGetMMapManager()->trimIdleTiles(GetId());
+
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
@@ -770,6 +851,12 @@ void Map::Update(const uint32 t_diff)
     /// update active cells around players and active objects
     resetMarkedCells();
 
+    // idle creatures outside of these cells update their AI at a reduced rate, see Creature::CanThrottleAIUpdate
+    // instanced maps never throttle
+    float aiUpdateLodDistance = sWorld->getFloatConfig(CONFIG_CREATURE_AI_UPDATE_LOD_DISTANCE);
+    if (aiUpdateLodDistance > 0.0f && !Instanceable())
+        MarkCellsNearPlayers(aiUpdateLodDistance);
+
     Trinity::ObjectUpdater updater(t_diff);
     // for creature
     TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
@@ -1071,6 +1158,8 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
             EnsureGridLoadedForActiveObject(new_cell, player);
 
         AddToGrid(player, new_cell);
+
+        PreloadGridsAhead(player);
     }
 
     player->UpdateObjectVisibility(false);
@@ -1899,7 +1988,7 @@ GridMap::GridMap()
     _areaMap = nullptr;
     // Height level data
     _gridHeight = INVALID_HEIGHT;
-    _gridGetHeight = &GridMap::getHeightFromFlat;
+    _heightFormat = HEIGHT_FORMAT_FLAT;
     _gridIntHeightMultiplier = 0;
     m_V9 = nullptr;
     m_V8 = nullptr;
@@ -1928,61 +2017,61 @@ bool GridMap::loadData(const char* filename)
     // Unload old data if exist
     unloadData();
 
-    map_fileheader header;
     // Not return error if file not found
-    FILE* in = fopen(filename, "rb");
-    if (!in)
+    boost::system::error_code error;
+    if (!boost::filesystem::is_regular_file(filename, error))
         return true;
 
     _fileExists = true;
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    try
     {
-        fclose(in);
+        // the mapping stays valid after the file handle is closed at the end of this scope
+        boost::interprocess::file_mapping file(filename, boost::interprocess::read_only);
+        _region = Trinity::make_unique<boost::interprocess::mapped_region>(file, boost::interprocess::read_only);
+    }
+    catch (std::exception const& e)
+    {
+        TC_LOG_ERROR("maps", "Could not map file '%s': %s", filename, e.what());
         return false;
     }
 
+    map_fileheader header;
+    if (!readStruct(0, header))
+        return false;
+
     if (header.mapMagic.asUInt == MapMagic.asUInt && header.versionMagic.asUInt == MapVersionMagic.asUInt)
     {
         // load up area data
-        if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
+        if (header.areaMapOffset && !loadAreaData(header.areaMapOffset, header.areaMapSize))
         {
             TC_LOG_ERROR("maps", "Error loading map area data\n");
-            fclose(in);
             return false;
         }
         // load up height data
-        if (header.heightMapOffset && !loadHeightData(in, header.heightMapOffset, header.heightMapSize))
+        if (header.heightMapOffset && !loadHeightData(header.heightMapOffset, header.heightMapSize))
         {
             TC_LOG_ERROR("maps", "Error loading map height data\n");
-            fclose(in);
             return false;
         }
         // load up liquid data
-        if (header.liquidMapOffset && !loadLiquidData(in, header.liquidMapOffset, header.liquidMapSize))
+        if (header.liquidMapOffset && !loadLiquidData(header.liquidMapOffset, header.liquidMapSize))
         {
             TC_LOG_ERROR("maps", "Error loading map liquids data\n");
-            fclose(in);
             return false;
         }
-        fclose(in);
         return true;
     }
 
     TC_LOG_ERROR("maps", "Map file '%s' is from an incompatible map version (%.*s %.*s), %.*s %.*s is expected. Please pull your source, recompile tools and recreate maps using the updated mapextractor, then replace your old map files with new files. If you still have problems search on forum for error TCE00018.",
         filename, 4, header.mapMagic.asChar, 4, header.versionMagic.asChar, 4, MapMagic.asChar, 4, MapVersionMagic.asChar);
-    fclose(in);
     return false;
 }
 
 void GridMap::unloadData()
 {
-    delete[] _areaMap;
-    delete[] m_V9;
-    delete[] m_V8;
     delete[] _minHeightPlanes;
-    delete[] _liquidEntry;
-    delete[] _liquidFlags;
-    delete[] _liquidMap;
+    _copies.clear();
+    _region.reset();
     _areaMap = nullptr;
     m_V9 = nullptr;
     m_V8 = nullptr;
@@ -1990,78 +2079,102 @@ void GridMap::unloadData()
     _liquidEntry = nullptr;
     _liquidFlags = nullptr;
     _liquidMap  = nullptr;
-    _gridGetHeight = &GridMap::getHeightFromFlat;
+    _heightFormat = HEIGHT_FORMAT_FLAT;
     _fileExists = false;
 }
 
-bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
+template<class T>
+bool GridMap::readStruct(uint32 offset, T& data) const
 {
-    map_areaHeader header;
-    fseek(in, offset, SEEK_SET);
+    if (offset > _region->get_size() || sizeof(T) > _region->get_size() - offset)
+        return false;
 
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapAreaMagic.asUInt)
+    memcpy(&data, static_cast<char const*>(_region->get_address()) + offset, sizeof(T));
+    return true;
+}
+
+template<class T>
+bool GridMap::mapArray(uint32 offset, std::size_t count, T const*& data)
+{
+    std::size_t size = count * sizeof(T);
+    if (offset > _region->get_size() || size > _region->get_size() - offset)
+        return false;
+
+    char const* source = static_cast<char const*>(_region->get_address()) + offset;
+    if (reinterpret_cast<uintptr_t>(source) % alignof(T) == 0)
+    {
+        data = reinterpret_cast<T const*>(source);
+        return true;
+    }
+
+    // sections are not padded by the extractor, an odd sized uint8 height map misaligns everything after it
+    std::unique_ptr<uint32[]> copy(new uint32[(size + sizeof(uint32) - 1) / sizeof(uint32)]);
+    memcpy(copy.get(), source, size);
+    data = reinterpret_cast<T const*>(copy.get());
+    _copies.push_back(std::move(copy));
+    return true;
+}
+
+bool GridMap::loadAreaData(uint32 offset, uint32 /*size*/)
+{
+    map_areaHeader header;
+    if (!readStruct(offset, header) || header.fourcc != MapAreaMagic.asUInt)
         return false;
 
     _gridArea = header.gridArea;
     if (!(header.flags & MAP_AREA_NO_AREA))
-    {
-        _areaMap = new uint16[16 * 16];
-        if (fread(_areaMap, sizeof(uint16), 16*16, in) != 16*16)
+        if (!mapArray(offset + sizeof(header), 16 * 16, _areaMap))
             return false;
-    }
+
     return true;
 }
 
-bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHeightData(uint32 offset, uint32 /*size*/)
 {
     map_heightHeader header;
-    fseek(in, offset, SEEK_SET);
-
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapHeightMagic.asUInt)
+    if (!readStruct(offset, header) || header.fourcc != MapHeightMagic.asUInt)
         return false;
 
+    offset += sizeof(header);
+
     _gridHeight = header.gridHeight;
     if (!(header.flags & MAP_HEIGHT_NO_HEIGHT))
     {
         if ((header.flags & MAP_HEIGHT_AS_INT16))
         {
-            m_uint16_V9 = new uint16 [129*129];
-            m_uint16_V8 = new uint16 [128*128];
-            if (fread(m_uint16_V9, sizeof(uint16), 129*129, in) != 129*129 ||
-                fread(m_uint16_V8, sizeof(uint16), 128*128, in) != 128*128)
+            if (!mapArray(offset, 129*129, m_uint16_V9) ||
+                !mapArray(offset + 129*129 * sizeof(uint16), 128*128, m_uint16_V8))
                 return false;
+            offset += (129*129 + 128*128) * sizeof(uint16);
             _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
-            _gridGetHeight = &GridMap::getHeightFromUint16;
+            _heightFormat = HEIGHT_FORMAT_UINT16;
         }
         else if ((header.flags & MAP_HEIGHT_AS_INT8))
         {
-            m_uint8_V9 = new uint8 [129*129];
-            m_uint8_V8 = new uint8 [128*128];
-            if (fread(m_uint8_V9, sizeof(uint8), 129*129, in) != 129*129 ||
-                fread(m_uint8_V8, sizeof(uint8), 128*128, in) != 128*128)
+            if (!mapArray(offset, 129*129, m_uint8_V9) ||
+                !mapArray(offset + 129*129 * sizeof(uint8), 128*128, m_uint8_V8))
                 return false;
+            offset += (129*129 + 128*128) * sizeof(uint8);
             _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
-            _gridGetHeight = &GridMap::getHeightFromUint8;
+            _heightFormat = HEIGHT_FORMAT_UINT8;
         }
         else
         {
-            m_V9 = new float [129*129];
-            m_V8 = new float [128*128];
-            if (fread(m_V9, sizeof(float), 129*129, in) != 129*129 ||
-                fread(m_V8, sizeof(float), 128*128, in) != 128*128)
+            if (!mapArray(offset, 129*129, m_V9) ||
+                !mapArray(offset + 129*129 * sizeof(float), 128*128, m_V8))
                 return false;
-            _gridGetHeight = &GridMap::getHeightFromFloat;
+            offset += (129*129 + 128*128) * sizeof(float);
+            _heightFormat = HEIGHT_FORMAT_FLOAT;
         }
     }
     else
-        _gridGetHeight = &GridMap::getHeightFromFlat;
+        _heightFormat = HEIGHT_FORMAT_FLAT;
 
     if (header.flags & MAP_HEIGHT_HAS_FLIGHT_BOUNDS)
     {
         std::array<int16, 9> maxHeights;
         std::array<int16, 9> minHeights;
-        if (fread(maxHeights.data(), sizeof(int16), maxHeights.size(), in) != maxHeights.size() ||
-            fread(minHeights.data(), sizeof(int16), minHeights.size(), in) != minHeights.size())
+        if (!readStruct(offset, maxHeights) || !readStruct(offset + sizeof(maxHeights), minHeights))
             return false;
 
         static uint32 constexpr indices[8][3] =
@@ -2101,14 +2214,14 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
-bool GridMap::loadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadLiquidData(uint32 offset, uint32 /*size*/)
 {
     map_liquidHeader header;
-    fseek(in, offset, SEEK_SET);
-
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapLiquidMagic.asUInt)
+    if (!readStruct(offset, header) || header.fourcc != MapLiquidMagic.asUInt)
         return false;
 
+    offset += sizeof(header);
+
     _liquidGlobalEntry = header.liquidType;
     _liquidGlobalFlags = header.liquidFlags;
     _liquidOffX  = header.offsetX;
@@ -2119,20 +2232,15 @@ bool GridMap::loadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (!(header.flags & MAP_LIQUID_NO_TYPE))
     {
-        _liquidEntry = new uint16[16*16];
-        if (fread(_liquidEntry, sizeof(uint16), 16*16, in) != 16*16)
-            return false;
-
-        _liquidFlags = new uint8[16*16];
-        if (fread(_liquidFlags, sizeof(uint8), 16*16, in) != 16*16)
+        if (!mapArray(offset, 16*16, _liquidEntry) ||
+            !mapArray(offset + 16*16 * sizeof(uint16), 16*16, _liquidFlags))
             return false;
+        offset += 16*16 * (sizeof(uint16) + sizeof(uint8));
     }
     if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
-    {
-        _liquidMap = new float[uint32(_liquidWidth) * uint32(_liquidHeight)];
-        if (fread(_liquidMap, sizeof(float), _liquidWidth*_liquidHeight, in) != (uint32(_liquidWidth) * uint32(_liquidHeight)))
+        if (!mapArray(offset, uint32(_liquidWidth) * uint32(_liquidHeight), _liquidMap))
             return false;
-    }
+
     return true;
 }
 
@@ -2148,16 +2256,9 @@ uint16 GridMap::getArea(float x, float y) const
     return _areaMap[lx*16 + ly];
 }
 
-float GridMap::getHeightFromFlat(float /*x*/, float /*y*/) const
-{
-    return _gridHeight;
-}
-
-float GridMap::getHeightFromFloat(float x, float y) const
+template<class T>
+float GridMap::sampleHeight(T const* v9, T const* v8, float x, float y) const
 {
-    if (!m_V8 || !m_V9)
-        return _gridHeight;
-
     x = MAP_RESOLUTION * (CENTER_GRID_ID - x/SIZE_OF_GRIDS);
     y = MAP_RESOLUTION * (CENTER_GRID_ID - y/SIZE_OF_GRIDS);
 
@@ -2182,191 +2283,133 @@ float GridMap::getHeightFromFloat(float x, float y) const
     // 1 - detect triangle
     // 2 - solve linear equation from triangle points
     // Calculate coefficients for solve h = a*x + b*y + c
+    //
+    // Integer heights are far below 2^24, converting them before the arithmetic is exact.
+    T const* V9_h1_ptr = &v9[x_int*128 + x_int + y_int];
+    float h1 = float(V9_h1_ptr[  0]);
+    float h2 = float(V9_h1_ptr[129]);
+    float h3 = float(V9_h1_ptr[  1]);
+    float h4 = float(V9_h1_ptr[130]);
+    float h5 = 2 * float(v8[x_int*128 + y_int]);
+
+    bool top = x+y < 1;                                     // triangles 1 and 2
+    bool right = x > y;                                     // triangles 1 and 3
+    float a = top ? (right ? h2 - h1 : h5 - h1 - h3) : (right ? h2 + h4 - h5 : h4 - h3);
+    float b = top ? (right ? h5 - h1 - h2 : h3 - h1) : (right ? h4 - h2 : h3 + h4 - h5);
+    float c = top ? h1 : h5 - h4;
 
-    float a, b, c;
-    // Select triangle:
-    if (x+y < 1)
-    {
-        if (x > y)
-        {
-            // 1 triangle (h1, h2, h5 points)
-            float h1 = m_V9[(x_int)*129 + y_int];
-            float h2 = m_V9[(x_int+1)*129 + y_int];
-            float h5 = 2 * m_V8[x_int*128 + y_int];
-            a = h2-h1;
-            b = h5-h1-h2;
-            c = h1;
-        }
-        else
-        {
-            // 2 triangle (h1, h3, h5 points)
-            float h1 = m_V9[x_int*129 + y_int  ];
-            float h3 = m_V9[x_int*129 + y_int+1];
-            float h5 = 2 * m_V8[x_int*128 + y_int];
-            a = h5 - h1 - h3;
-            b = h3 - h1;
-            c = h1;
-        }
-    }
-    else
-    {
-        if (x > y)
-        {
-            // 3 triangle (h2, h4, h5 points)
-            float h2 = m_V9[(x_int+1)*129 + y_int  ];
-            float h4 = m_V9[(x_int+1)*129 + y_int+1];
-            float h5 = 2 * m_V8[x_int*128 + y_int];
-            a = h2 + h4 - h5;
-            b = h4 - h2;
-            c = h5 - h4;
-        }
-        else
-        {
-            // 4 triangle (h3, h4, h5 points)
-            float h3 = m_V9[(x_int)*129 + y_int+1];
-            float h4 = m_V9[(x_int+1)*129 + y_int+1];
-            float h5 = 2 * m_V8[x_int*128 + y_int];
-            a = h4 - h3;
-            b = h3 + h4 - h5;
-            c = h5 - h4;
-        }
-    }
     // Calculate height
-    return a * x + b * y + c;
+    float height = a * x + b * y + c;
+    if (std::is_same<T, float>::value)
+        return height;
+
+    return height*_gridIntHeightMultiplier + _gridHeight;
 }
 
-float GridMap::getHeightFromUint8(float x, float y) const
+namespace
 {
-    if (!m_uint8_V8 || !m_uint8_V9)
-        return _gridHeight;
+    // bitwise a or b, unlike ?: the compiler never turns this back into a branch
+    inline float SelectFloat(bool condition, float a, float b)
+    {
+        uint32 bitsA, bitsB;
+        memcpy(&bitsA, &a, sizeof(float));
+        memcpy(&bitsB, &b, sizeof(float));
+        uint32 mask = uint32(0) - uint32(condition);
+        uint32 bits = (bitsA & mask) | (bitsB & ~mask);
+        float result;
+        memcpy(&result, &bits, sizeof(float));
+        return result;
+    }
+}
 
-    x = MAP_RESOLUTION * (CENTER_GRID_ID - x/SIZE_OF_GRIDS);
-    y = MAP_RESOLUTION * (CENTER_GRID_ID - y/SIZE_OF_GRIDS);
+template<class T>
+void GridMap::sampleHeights(T const* v9, T const* v8, float const* x, float const* y, float* heights, std::size_t count) const
+{
+    // Same math as sampleHeight, split in two passes over blocks of points.
+    // The first pass gathers the five heights around every point, those loads are scattered and stay scalar.
+    // The second pass only reads these contiguous arrays, evaluates all four triangles and picks one with
+    // SelectFloat, it has a fixed trip count and no branches so it is vectorized (SSE2 is enough).
+    std::size_t const BlockSize = 64;
+    float fx[BlockSize] = { }, fy[BlockSize] = { };
+    float h1[BlockSize] = { }, h2[BlockSize] = { }, h3[BlockSize] = { }, h4[BlockSize] = { }, h5[BlockSize] = { };
+    float result[BlockSize];
 
-    int x_int = (int)x;
-    int y_int = (int)y;
-    x -= x_int;
-    y -= y_int;
-    x_int&=(MAP_RESOLUTION - 1);
-    y_int&=(MAP_RESOLUTION - 1);
+    float const scale = std::is_same<T, float>::value ? 1.0f : _gridIntHeightMultiplier;
+    float const offset = std::is_same<T, float>::value ? 0.0f : _gridHeight;
 
-    int32 a, b, c;
-    uint8 *V9_h1_ptr = &m_uint8_V9[x_int*128 + x_int + y_int];
-    if (x+y < 1)
+    for (std::size_t begin = 0; begin < count; begin += BlockSize)
     {
-        if (x > y)
-        {
-            // 1 triangle (h1, h2, h5 points)
-            int32 h1 = V9_h1_ptr[  0];
-            int32 h2 = V9_h1_ptr[129];
-            int32 h5 = 2 * m_uint8_V8[x_int*128 + y_int];
-            a = h2-h1;
-            b = h5-h1-h2;
-            c = h1;
-        }
-        else
+        std::size_t blockCount = std::min(BlockSize, count - begin);
+        for (std::size_t i = 0; i < blockCount; ++i)
         {
-            // 2 triangle (h1, h3, h5 points)
-            int32 h1 = V9_h1_ptr[0];
-            int32 h3 = V9_h1_ptr[1];
-            int32 h5 = 2 * m_uint8_V8[x_int*128 + y_int];
-            a = h5 - h1 - h3;
-            b = h3 - h1;
-            c = h1;
+            float px = MAP_RESOLUTION * (CENTER_GRID_ID - x[begin + i] / SIZE_OF_GRIDS);
+            float py = MAP_RESOLUTION * (CENTER_GRID_ID - y[begin + i] / SIZE_OF_GRIDS);
+            int x_int = (int)px;
+            int y_int = (int)py;
+            fx[i] = px - x_int;
+            fy[i] = py - y_int;
+            x_int &= (MAP_RESOLUTION - 1);
+            y_int &= (MAP_RESOLUTION - 1);
+
+            T const* V9_h1_ptr = &v9[x_int*128 + x_int + y_int];
+            h1[i] = float(V9_h1_ptr[  0]);
+            h2[i] = float(V9_h1_ptr[129]);
+            h3[i] = float(V9_h1_ptr[  1]);
+            h4[i] = float(V9_h1_ptr[130]);
+            h5[i] = 2 * float(v8[x_int*128 + y_int]);
         }
-    }
-    else
-    {
-        if (x > y)
-        {
-            // 3 triangle (h2, h4, h5 points)
-            int32 h2 = V9_h1_ptr[129];
-            int32 h4 = V9_h1_ptr[130];
-            int32 h5 = 2 * m_uint8_V8[x_int*128 + y_int];
-            a = h2 + h4 - h5;
-            b = h4 - h2;
-            c = h5 - h4;
-        }
-        else
+
+        // lanes past blockCount hold stale or zero input, their result is not copied out
+        for (std::size_t i = 0; i < BlockSize; ++i)
         {
-            // 4 triangle (h3, h4, h5 points)
-            int32 h3 = V9_h1_ptr[  1];
-            int32 h4 = V9_h1_ptr[130];
-            int32 h5 = 2 * m_uint8_V8[x_int*128 + y_int];
-            a = h4 - h3;
-            b = h3 + h4 - h5;
-            c = h5 - h4;
+            bool top = fx[i] + fy[i] < 1;                   // triangles 1 and 2
+            bool right = fx[i] > fy[i];                     // triangles 1 and 3
+            float aTop = SelectFloat(right, h2[i] - h1[i], h5[i] - h1[i] - h3[i]);
+            float aBottom = SelectFloat(right, h2[i] + h4[i] - h5[i], h4[i] - h3[i]);
+            float bTop = SelectFloat(right, h5[i] - h1[i] - h2[i], h3[i] - h1[i]);
+            float bBottom = SelectFloat(right, h4[i] - h2[i], h3[i] + h4[i] - h5[i]);
+            float a = SelectFloat(top, aTop, aBottom);
+            float b = SelectFloat(top, bTop, bBottom);
+            float c = SelectFloat(top, h1[i], h5[i] - h4[i]);
+            result[i] = (a * fx[i] + b * fy[i] + c) * scale + offset;
         }
+
+        std::copy(result, result + blockCount, heights + begin);
     }
-    // Calculate height
-    return (float)((a * x) + (b * y) + c)*_gridIntHeightMultiplier + _gridHeight;
 }
 
-float GridMap::getHeightFromUint16(float x, float y) const
+float GridMap::getHeight(float x, float y) const
 {
-    if (!m_uint16_V8 || !m_uint16_V9)
-        return _gridHeight;
-
-    x = MAP_RESOLUTION * (CENTER_GRID_ID - x/SIZE_OF_GRIDS);
-    y = MAP_RESOLUTION * (CENTER_GRID_ID - y/SIZE_OF_GRIDS);
-
-    int x_int = (int)x;
-    int y_int = (int)y;
-    x -= x_int;
-    y -= y_int;
-    x_int&=(MAP_RESOLUTION - 1);
-    y_int&=(MAP_RESOLUTION - 1);
-
-    int32 a, b, c;
-    uint16 *V9_h1_ptr = &m_uint16_V9[x_int*128 + x_int + y_int];
-    if (x+y < 1)
+    switch (_heightFormat)
     {
-        if (x > y)
-        {
-            // 1 triangle (h1, h2, h5 points)
-            int32 h1 = V9_h1_ptr[  0];
-            int32 h2 = V9_h1_ptr[129];
-            int32 h5 = 2 * m_uint16_V8[x_int*128 + y_int];
-            a = h2-h1;
-            b = h5-h1-h2;
-            c = h1;
-        }
-        else
-        {
-            // 2 triangle (h1, h3, h5 points)
-            int32 h1 = V9_h1_ptr[0];
-            int32 h3 = V9_h1_ptr[1];
-            int32 h5 = 2 * m_uint16_V8[x_int*128 + y_int];
-            a = h5 - h1 - h3;
-            b = h3 - h1;
-            c = h1;
-        }
+        case HEIGHT_FORMAT_FLOAT:
+            return sampleHeight(m_V9, m_V8, x, y);
+        case HEIGHT_FORMAT_UINT16:
+            return sampleHeight(m_uint16_V9, m_uint16_V8, x, y);
+        case HEIGHT_FORMAT_UINT8:
+            return sampleHeight(m_uint8_V9, m_uint8_V8, x, y);
+        default:
+            return _gridHeight;
     }
-    else
+}
+
+void GridMap::getHeights(float const* x, float const* y, float* heights, std::size_t count) const
+{
+    switch (_heightFormat)
     {
-        if (x > y)
-        {
-            // 3 triangle (h2, h4, h5 points)
-            int32 h2 = V9_h1_ptr[129];
-            int32 h4 = V9_h1_ptr[130];
-            int32 h5 = 2 * m_uint16_V8[x_int*128 + y_int];
-            a = h2 + h4 - h5;
-            b = h4 - h2;
-            c = h5 - h4;
-        }
-        else
-        {
-            // 4 triangle (h3, h4, h5 points)
-            int32 h3 = V9_h1_ptr[  1];
-            int32 h4 = V9_h1_ptr[130];
-            int32 h5 = 2 * m_uint16_V8[x_int*128 + y_int];
-            a = h4 - h3;
-            b = h3 + h4 - h5;
-            c = h5 - h4;
-        }
+        case HEIGHT_FORMAT_FLOAT:
+            sampleHeights(m_V9, m_V8, x, y, heights, count);
+            break;
+        case HEIGHT_FORMAT_UINT16:
+            sampleHeights(m_uint16_V9, m_uint16_V8, x, y, heights, count);
+            break;
+        case HEIGHT_FORMAT_UINT8:
+            sampleHeights(m_uint8_V9, m_uint8_V8, x, y, heights, count);
+            break;
+        default:
+            std::fill(heights, heights + count, _gridHeight);
+            break;
     }
-    // Calculate height
-    return (float)((a * x) + (b * y) + c)*_gridIntHeightMultiplier + _gridHeight;
 }
 
 float GridMap::getMinHeight(float x, float y) const
@@ -2581,25 +2624,29 @@ float Map::GetWaterOrGroundLevel(PhaseShift const& phaseShift, float x, float y,
 
 float Map::GetStaticHeight(PhaseShift const& phaseShift, float x, float y, float z, bool checkVMap /*= true*/, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/) const
 {
-    // find raw .map surface under Z coordinates
-    float mapHeight = VMAP_INVALID_HEIGHT_VALUE;
+    float gridHeight = VMAP_INVALID_HEIGHT_VALUE;
     uint32 terrainMapId = PhasingHandler::GetTerrainMapId(phaseShift, this, x, y);
     if (GridMap* gmap = m_parentTerrainMap->GetGrid(terrainMapId, x, y))
-    {
-        float gridHeight = gmap->getHeight(x, y);
-        // look from a bit higher pos to find the floor, ignore under surface case
-        if (z + 2.0f > gridHeight)
-            mapHeight = gridHeight;
-    }
+        gridHeight = gmap->getHeight(x, y);
 
     float vmapHeight = VMAP_INVALID_HEIGHT_VALUE;
     if (checkVMap)
     {
         VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
         if (vmgr->isHeightCalcEnabled())
-            vmapHeight = vmgr->getHeight(terrainMapId, x, y, z + 2.0f, maxSearchDist);   // look from a bit higher pos to find the floor
+            vmapHeight = _collisionCache->GetHeight(vmgr, terrainMapId, x, y, z + 2.0f, maxSearchDist);   // look from a bit higher pos to find the floor
     }
 
+    return SelectStaticHeight(z, gridHeight, vmapHeight);
+}
+
+float Map::SelectStaticHeight(float z, float gridHeight, float vmapHeight)
+{
+    // raw .map surface under Z coordinates, look from a bit higher pos to find the floor, ignore under surface case
+    float mapHeight = VMAP_INVALID_HEIGHT_VALUE;
+    if (z + 2.0f > gridHeight)
+        mapHeight = gridHeight;
+
     // mapHeight set for any above raw ground Z or <= INVALID_HEIGHT
     // vmapheight set for any under Z value or <= INVALID_HEIGHT
     if (vmapHeight > INVALID_HEIGHT)
@@ -2888,7 +2935,7 @@ float Map::GetWaterLevel(PhaseShift const& phaseShift, float x, float y) const
 
 bool Map::isInLineOfSight(PhaseShift const& phaseShift, float x1, float y1, float z1, float x2, float y2, float z2, VMAP::ModelIgnoreFlags ignoreFlags) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(PhasingHandler::GetTerrainMapId(phaseShift, this, x1, y1), x1, y1, z1, x2, y2, z2, ignoreFlags)
+    return _collisionCache->IsInLineOfSight(VMAP::VMapFactory::createOrGetVMapManager(), PhasingHandler::GetTerrainMapId(phaseShift, this, x1, y1), x1, y1, z1, x2, y2, z2, ignoreFlags)
         && _dynamicTree.isInLineOfSight({ x1, y1, z1 }, { x2, y2, z2 }, phaseShift);
 }
 
@@ -2911,6 +2958,49 @@ float Map::GetHeight(PhaseShift const& phaseShift, float x, float y, float z, bo
     return std::max<float>(GetStaticHeight(phaseShift, x, y, z, vmap, maxSearchDist), _dynamicTree.getHeight(x, y, z, maxSearchDist, phaseShift));
 }
 
+void Map::GetHeights(PhaseShift const& phaseShift, float const* x, float const* y, float const* z, float* heights, std::size_t count, bool vmap /*= true*/, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/) const
+{
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    bool checkVMap = vmap && vmgr->isHeightCalcEnabled();
+
+    // terrain, vmap and gameobject heights are each fetched with one batch call per run of points on the same grid
+    // the vmap rays look from a bit higher pos to find the floor
+    std::vector<float> raisedZ(z, z + count);
+    for (float& pointZ : raisedZ)
+        pointZ += 2.0f;
+
+    std::vector<float> vmapHeights(count, VMAP_INVALID_HEIGHT_VALUE);
+    std::vector<float> dynamicHeights(count);
+    _dynamicTree.getHeights(x, y, z, dynamicHeights.data(), count, maxSearchDist, phaseShift);
+
+    std::size_t begin = 0;
+    while (begin < count)
+    {
+        // consecutive points on the same grid (and terrain) share one GridMap::getHeights call
+        uint32 terrainMapId = PhasingHandler::GetTerrainMapId(phaseShift, this, x[begin], y[begin]);
+        int gx = (int)(CENTER_GRID_ID - x[begin] / SIZE_OF_GRIDS);
+        int gy = (int)(CENTER_GRID_ID - y[begin] / SIZE_OF_GRIDS);
+
+        std::size_t end = begin + 1;
+        while (end < count && (int)(CENTER_GRID_ID - x[end] / SIZE_OF_GRIDS) == gx && (int)(CENTER_GRID_ID - y[end] / SIZE_OF_GRIDS) == gy &&
+            PhasingHandler::GetTerrainMapId(phaseShift, this, x[end], y[end]) == terrainMapId)
+            ++end;
+
+        if (GridMap* gmap = m_parentTerrainMap->GetGrid(terrainMapId, x[begin], y[begin]))
+            gmap->getHeights(x + begin, y + begin, heights + begin, end - begin);
+        else
+            std::fill(heights + begin, heights + end, VMAP_INVALID_HEIGHT_VALUE);
+
+        if (checkVMap)
+            _collisionCache->GetHeights(vmgr, terrainMapId, x + begin, y + begin, raisedZ.data() + begin, vmapHeights.data() + begin, end - begin, maxSearchDist);
+
+        for (std::size_t i = begin; i < end; ++i)
+            heights[i] = std::max<float>(SelectStaticHeight(z[i], heights[i], vmapHeights[i]), dynamicHeights[i]);
+
+        begin = end;
+    }
+}
+
 bool Map::IsInWater(PhaseShift const& phaseShift, float x, float y, float pZ, LiquidData* data) const
 {
     LiquidData liquid_status;
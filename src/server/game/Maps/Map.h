@@ -48,6 +48,8 @@ class InstanceScript;
 class InstanceScenario;
 class MapInstanced;
 class Object;
+class CollisionCache;
+class PathCache;
 class PhaseShift;
 class Player;
 class Spell;
@@ -69,6 +71,7 @@ enum WeatherState : uint32;
 
 namespace Trinity { struct ObjectUpdater; }
 namespace G3D { class Plane; }
+namespace boost { namespace interprocess { class mapped_region; } }
 namespace VMAP { enum class ModelIgnoreFlags : uint32; }
 
 struct ScriptAction
@@ -169,18 +172,32 @@ struct LiquidData
     float  depth_level;
 };
 
+// Terrain of one tile, arrays point straight into the memory mapped .map file (the page cache is shared by every process using it)
+// the file itself is closed once mapped, loaded tiles do not hold file descriptors
 class TC_GAME_API GridMap
 {
+    // every height format is sampled by the same kernel, integer formats are scaled by _gridIntHeightMultiplier and offset by _gridHeight
+    enum HeightFormat : uint8
+    {
+        HEIGHT_FORMAT_FLAT,
+        HEIGHT_FORMAT_FLOAT,
+        HEIGHT_FORMAT_UINT16,
+        HEIGHT_FORMAT_UINT8
+    };
+
+    std::unique_ptr<boost::interprocess::mapped_region> _region;
+    std::vector<std::unique_ptr<uint32[]>> _copies;        // arrays that were not aligned in the file
     uint32  _flags;
+    HeightFormat _heightFormat;
     union{
-        float* m_V9;
-        uint16* m_uint16_V9;
-        uint8* m_uint8_V9;
+        float const* m_V9;
+        uint16 const* m_uint16_V9;
+        uint8 const* m_uint8_V9;
     };
     union{
-        float* m_V8;
-        uint16* m_uint16_V8;
-        uint8* m_uint8_V8;
+        float const* m_V8;
+        uint16 const* m_uint16_V8;
+        uint8 const* m_uint8_V8;
     };
     G3D::Plane* _minHeightPlanes;
     // Height level data
@@ -188,13 +205,13 @@ class TC_GAME_API GridMap
     float _gridIntHeightMultiplier;
 
     // Area data
-    uint16* _areaMap;
+    uint16 const* _areaMap;
 
     // Liquid data
     float _liquidLevel;
-    uint16* _liquidEntry;
-    uint8* _liquidFlags;
-    float* _liquidMap;
+    uint16 const* _liquidEntry;
+    uint8 const* _liquidFlags;
+    float const* _liquidMap;
     uint16 _gridArea;
     uint16 _liquidGlobalEntry;
     uint8 _liquidGlobalFlags;
@@ -204,17 +221,19 @@ class TC_GAME_API GridMap
     uint8 _liquidHeight;
     bool _fileExists;
 
-    bool loadAreaData(FILE* in, uint32 offset, uint32 size);
-    bool loadHeightData(FILE* in, uint32 offset, uint32 size);
-    bool loadLiquidData(FILE* in, uint32 offset, uint32 size);
+    bool loadAreaData(uint32 offset, uint32 size);
+    bool loadHeightData(uint32 offset, uint32 size);
+    bool loadLiquidData(uint32 offset, uint32 size);
+
+    template<class T>
+    bool readStruct(uint32 offset, T& data) const;
+    template<class T>
+    bool mapArray(uint32 offset, std::size_t count, T const*& data);
 
-    // Get height functions and pointers
-    typedef float (GridMap::*GetHeightPtr) (float x, float y) const;
-    GetHeightPtr _gridGetHeight;
-    float getHeightFromFloat(float x, float y) const;
-    float getHeightFromUint16(float x, float y) const;
-    float getHeightFromUint8(float x, float y) const;
-    float getHeightFromFlat(float x, float y) const;
+    template<class T>
+    float sampleHeight(T const* v9, T const* v8, float x, float y) const;
+    template<class T>
+    void sampleHeights(T const* v9, T const* v8, float const* x, float const* y, float* heights, std::size_t count) const;
 
 public:
     GridMap();
@@ -223,7 +242,9 @@ public:
     void unloadData();
 
     uint16 getArea(float x, float y) const;
-    inline float getHeight(float x, float y) const {return (this->*_gridGetHeight)(x, y);}
+    float getHeight(float x, float y) const;
+    // samples count points of this tile at once, the height format is only resolved once for the whole batch
+    void getHeights(float const* x, float const* y, float* heights, std::size_t count) const;
     float getMinHeight(float x, float y) const;
     float getLiquidLevel(float x, float y) const;
     uint8 getTerrainType(float x, float y) const;
@@ -424,6 +445,9 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         bool isCellMarked(uint32 pCellId) { return marked_cells.test(pCellId); }
         void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
 
+        // cells within Creature.AIUpdateLOD.Distance of a player (or its far sight viewpoint) during this update
+        bool IsCellNearPlayers(uint32 cellId) const { return m_cellsNearPlayers.test(cellId); }
+
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
         bool ActiveObjectsNearGrid(NGridType const& ngrid) const;
@@ -503,6 +527,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
         float GetWaterOrGroundLevel(PhaseShift const& phaseShift, float x, float y, float z, float* ground = nullptr, bool swim = false) const;
         float GetHeight(PhaseShift const& phaseShift, float x, float y, float z, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
+        // GetHeight for count points at once, terrain, vmap and gameobject heights of consecutive points on the same grid are each fetched in one batch
+        void GetHeights(PhaseShift const& phaseShift, float const* x, float const* y, float const* z, float* heights, std::size_t count, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
         bool isInLineOfSight(PhaseShift const& phaseShift, float x1, float y1, float z1, float x2, float y2, float z2, VMAP::ModelIgnoreFlags ignoreFlags) const;
         void Balance() { _dynamicTree.balance(); }
         void RemoveGameObjectModel(const GameObjectModel& model) { _dynamicTree.remove(model); }
@@ -580,6 +606,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
             _updateObjects.erase(obj);
         }
 
+        PathCache& GetPathCache() { return *_pathCache; }
+
     private:
         void LoadMapAndVMap(int gx, int gy);
         void LoadVMap(int gx, int gy);
@@ -590,6 +618,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         void LoadMMap(int gx, int gy);
         GridMap* GetGrid(float x, float y);
         GridMap* GetGrid(uint32 mapId, float x, float y);
+        static float SelectStaticHeight(float z, float gridHeight, float vmapHeight);
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
 
@@ -627,6 +656,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         void EnsureGridCreated_i(const GridCoord &);
         bool EnsureGridLoaded(Cell const&);
         void EnsureGridLoadedForActiveObject(Cell const&, WorldObject* object);
+        void PreloadGridsAhead(Player const* player);
 
         void buildNGridLinkage(NGridType* pNGridType) { pNGridType->link(this); }
 
@@ -693,6 +723,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         GridMap* GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         uint16 GridMapReference[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> m_cellsNearPlayers;
+        void MarkCellsNearPlayers(float distance);
 
         //these functions used to process player/mob aggro reactions and
         //visibility calculations. Highly optimized for massive calculations
@@ -741,6 +773,9 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         IntervalTimer _weatherUpdateTimer;
         uint32 _defaultLight;
 
+        std::unique_ptr<PathCache> _pathCache;
+        std::unique_ptr<CollisionCache> _collisionCache;
+
         template<HighGuid high>
         inline ObjectGuidGeneratorBase& GetGuidSequenceGenerator()
         {
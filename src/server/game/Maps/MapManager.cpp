@@ -53,6 +53,9 @@ void MapManager::Initialize()
     // Start mtmaps if needed.
     if (num_threads > 0)
         m_updater.activate(num_threads);
+
+    if (int32 preloadThreads = sWorld->getIntConfig(CONFIG_GRID_PRELOAD_THREADS))
+        _gridPreloader.Activate(preloadThreads, sWorld->GetDataPath());
 }
 
 void MapManager::InitializeParentMapData(std::unordered_map<uint32, std::vector<uint32>> const& mapData)
@@ -252,6 +255,9 @@ void MapManager::Update(uint32 diff)
     for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
 
+    if (_gridPreloader.IsActive())
+        _gridPreloader.Update();
+
     i_timer.SetCurrent(0);
 }
 
@@ -281,6 +287,10 @@ bool MapManager::IsValidMAP(uint32 mapid, bool startUp)
 
 void MapManager::UnloadAll()
 {
+    // preloaded models are released through the vmap manager, stop before maps and their trees go away
+    if (_gridPreloader.IsActive())
+        _gridPreloader.Deactivate();
+
     // first unlink child maps
     for (auto iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->UnlinkAllChildTerrainMaps();
@@ -23,6 +23,7 @@
 #include "Map.h"
 #include "MapInstanced.h"
 #include "GridStates.h"
+#include "GridPreloader.h"
 #include "MapUpdater.h"
 
 class PhaseShift;
@@ -121,6 +122,7 @@ class TC_GAME_API MapManager
         void SetNextInstanceId(uint32 nextInstanceId) { _nextInstanceId = nextInstanceId; };
 
         MapUpdater * GetMapUpdater() { return &m_updater; }
+        GridPreloader& GetGridPreloader() { return _gridPreloader; }
 
         template<typename Worker>
         void DoForAllMaps(Worker&& worker);
@@ -159,6 +161,7 @@ class TC_GAME_API MapManager
         InstanceIds _instanceIds;
         uint32 _nextInstanceId;
         MapUpdater m_updater;
+        GridPreloader _gridPreloader;
 
         // atomic op counter for active scripts amount
         std::atomic<std::size_t> _scheduledScripts;
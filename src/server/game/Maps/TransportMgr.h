@@ -102,7 +102,7 @@ typedef std::map<uint32, TransportAnimation> TransportAnimationContainer;
 
 class TC_GAME_API TransportMgr
 {
-        friend void DB2Manager::LoadStores(std::string const&, uint32);
+        friend void DB2Manager::LoadStores(std::string const&, uint32, uint32);
 
     public:
         static TransportMgr* instance();
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FlowField.h"
+#include "DetourCommon.h"
+#include "DetourNavMeshQuery.h"
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace
+{
+    void GetPolyCenter(dtMeshTile const* tile, dtPoly const* poly, float* center)
+    {
+        center[0] = center[1] = center[2] = 0.0f;
+        for (uint8 i = 0; i < poly->vertCount; ++i)
+            dtVadd(center, center, &tile->verts[poly->verts[i] * 3]);
+
+        dtVscale(center, center, 1.0f / poly->vertCount);
+    }
+}
+
+bool FlowField::Build(dtNavMesh const* navMesh, dtPolyRef destination, dtQueryFilter const& filter)
+{
+    typedef std::pair<float, dtPolyRef> OpenNode;
+
+    _nodes.clear();
+    _destination = destination;
+    _stale = false;
+
+    dtMeshTile const* tile = nullptr;
+    dtPoly const* poly = nullptr;
+    if (dtStatusFailed(navMesh->getTileAndPolyByRef(destination, &tile, &poly)))
+        return false;
+
+    std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>> open;
+    _nodes[destination] = { 0, 0.0f };
+    open.emplace(0.0f, destination);
+
+    while (!open.empty() && _nodes.size() < MaxPolys)
+    {
+        OpenNode current = open.top();
+        open.pop();
+
+        // already reached through a cheaper neighbour
+        if (current.first > _nodes[current.second].Cost)
+            continue;
+
+        navMesh->getTileAndPolyByRefUnsafe(current.second, &tile, &poly);
+        if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION)
+            continue;
+
+        float center[3];
+        GetPolyCenter(tile, poly, center);
+
+        for (uint32 i = poly->firstLink; i != DT_NULL_LINK; i = tile->links[i].next)
+        {
+            dtPolyRef neighbourRef = tile->links[i].ref;
+            if (!neighbourRef)
+                continue;
+
+            dtMeshTile const* neighbourTile = nullptr;
+            dtPoly const* neighbourPoly = nullptr;
+            navMesh->getTileAndPolyByRefUnsafe(neighbourRef, &neighbourTile, &neighbourPoly);
+            if (neighbourPoly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION || !filter.passFilter(neighbourRef, neighbourTile, neighbourPoly))
+                continue;
+
+            float neighbourCenter[3];
+            GetPolyCenter(neighbourTile, neighbourPoly, neighbourCenter);
+            float cost = current.first + dtVdist(center, neighbourCenter) * filter.getAreaCost(neighbourPoly->getArea());
+
+            auto itr = _nodes.find(neighbourRef);
+            if (itr != _nodes.end() && itr->second.Cost <= cost)
+                continue;
+
+            _nodes[neighbourRef] = { current.second, cost };
+            open.emplace(cost, neighbourRef);
+        }
+    }
+
+    return true;
+}
+
+bool FlowField::GetCorridor(dtNavMesh const* navMesh, dtPolyRef start, dtPolyRef* path, uint32& length, uint32 maxLength) const
+{
+    auto itr = _nodes.find(start);
+    if (itr == _nodes.end())
+        return false;
+
+    uint32 count = 0;
+    dtPolyRef ref = start;
+    while (true)
+    {
+        if (count >= maxLength)
+            return false;
+
+        // salts change when a tile is reloaded, old references of the field point to nothing or to other polygons
+        if (!navMesh->isValidPolyRef(ref))
+        {
+            _stale = true;
+            return false;
+        }
+
+        path[count++] = ref;
+        if (ref == _destination)
+            break;
+
+        ref = itr->second.Next;
+        itr = _nodes.find(ref);
+        if (itr == _nodes.end())
+            return false;
+    }
+
+    length = count;
+    return true;
+}
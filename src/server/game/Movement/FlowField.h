@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_FLOWFIELD_H
+#define TRINITY_FLOWFIELD_H
+
+#include "Define.h"
+#include "DetourNavMesh.h"
+#include <unordered_map>
+
+class dtQueryFilter;
+
+/*
+ * Dijkstra map over the navmesh polygons around a destination.
+ * Every polygon reached by the expansion knows the next polygon on its cheapest way to the destination,
+ * so the corridor of any unit heading there is read one O(1) step at a time instead of running an A* search.
+ * Off-mesh connections are not expanded, they can be one way and the field is walked backwards.
+ */
+class TC_GAME_API FlowField
+{
+public:
+    static std::size_t const MaxPolys = 4096;
+
+    FlowField() : _destination(0), _stale(false) { }
+
+    // fails when the destination is not a polygon of navMesh (tile not loaded, stale reference)
+    bool Build(dtNavMesh const* navMesh, dtPolyRef destination, dtQueryFilter const& filter);
+
+    // copies the corridor from start to the destination to path (room for maxLength polygons)
+    bool GetCorridor(dtNavMesh const* navMesh, dtPolyRef start, dtPolyRef* path, uint32& length, uint32 maxLength) const;
+
+    // set once a corridor ran into a polygon of a tile that was unloaded since the field was built
+    bool IsStale() const { return _stale; }
+    std::size_t GetSize() const { return _nodes.size(); }
+
+private:
+    struct Node
+    {
+        dtPolyRef Next;
+        float Cost;
+    };
+
+    std::unordered_map<dtPolyRef, Node> _nodes;
+    dtPolyRef _destination;
+    mutable bool _stale;
+};
+
+#endif // TRINITY_FLOWFIELD_H
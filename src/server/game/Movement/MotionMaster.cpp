@@ -514,19 +514,20 @@ void MotionMaster::MoveCirclePath(float x, float y, float z, float radius, bool
 
     Movement::MoveSplineInit init(_owner);
 
+    std::vector<float> pointsX(stepCount), pointsY(stepCount), pointsZ(stepCount, z);
     for (uint8 i = 0; i < stepCount; angle += step, ++i)
     {
-        G3D::Vector3 point;
-        point.x = x + radius * cosf(angle);
-        point.y = y + radius * sinf(angle);
+        pointsX[i] = x + radius * cosf(angle);
+        pointsY[i] = y + radius * sinf(angle);
+    }
 
-        if (_owner->IsFlying())
-            point.z = z;
-        else
-            point.z = _owner->GetMap()->GetHeight(_owner->GetPhaseShift(), point.x, point.y, z);
+    // the whole circle usually lies on one grid, sample the terrain in one batch
+    std::vector<float> heights(pointsZ);
+    if (!_owner->IsFlying())
+        _owner->GetMap()->GetHeights(_owner->GetPhaseShift(), pointsX.data(), pointsY.data(), pointsZ.data(), heights.data(), stepCount);
 
-        init.Path().push_back(point);
-    }
+    for (uint8 i = 0; i < stepCount; ++i)
+        init.Path().push_back(G3D::Vector3(pointsX[i], pointsY[i], heights[i]));
 
     if (_owner->IsFlying())
     {
@@ -82,13 +82,17 @@ void RandomMovementGenerator<Creature>::_setRandomLocation(Creature* creature)
 
         if (std::fabs(destZ - respZ) > travelDistZ)              // Map check
         {
-            // Vmap Horizontal or above
-            destZ = map->GetHeight(creature->GetPhaseShift(), destX, destY, respZ - 2.0f, true);
-
+            // Vmap Horizontal or above, and Vmap Higher - both probes share one batch
+            float const pointsX[2] = { destX, destX };
+            float const pointsY[2] = { destY, destY };
+            float const pointsZ[2] = { respZ - 2.0f, respZ + travelDistZ - 2.0f };
+            float heights[2];
+            map->GetHeights(creature->GetPhaseShift(), pointsX, pointsY, pointsZ, heights, 2, true);
+
+            destZ = heights[0];
             if (std::fabs(destZ - respZ) > travelDistZ)
             {
-                // Vmap Higher
-                destZ = map->GetHeight(creature->GetPhaseShift(), destX, destY, respZ+travelDistZ-2.0f, true);
+                destZ = heights[1];
 
                 // let's forget this bad coords where a z cannot be find and retry at next tick
                 if (std::fabs(destZ - respZ) > travelDistZ)
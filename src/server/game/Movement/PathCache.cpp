@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PathCache.h"
+#include "Hash.h"
+#include "Timer.h"
+#include <algorithm>
+
+std::size_t PathCache::KeyHash::operator()(Key const& key) const
+{
+    std::size_t hash = 0;
+    Trinity::hash_combine(hash, key.NavMesh);
+    Trinity::hash_combine(hash, key.StartPoly);
+    Trinity::hash_combine(hash, key.EndPoly);
+    Trinity::hash_combine(hash, (uint32(key.IncludeFlags) << 16) | key.ExcludeFlags);
+    return hash;
+}
+
+bool PathCache::Find(Key const& key, dtQueryFilter const& filter, dtPolyRef* path, uint32& length, uint32 maxLength)
+{
+    uint32 now = getMSTime();
+    if (FindInFlowField(key, filter, now, path, length, maxLength))
+        return true;
+
+    auto itr = _entries.find(key);
+    if (itr == _entries.end() || itr->second.Path.size() > maxLength)
+        return false;
+
+    if (getMSTimeDiff(itr->second.Time, now) >= Lifetime)
+    {
+        _entries.erase(itr);
+        return false;
+    }
+
+    length = uint32(itr->second.Path.size());
+    std::copy(itr->second.Path.begin(), itr->second.Path.end(), path);
+    return true;
+}
+
+void PathCache::Store(Key const& key, dtPolyRef const* path, uint32 length)
+{
+    uint32 now = getMSTime();
+    if (_entries.size() >= MaxEntries)
+    {
+        RemoveExpired(now);
+
+        // every entry is fresh, a map this busy does not reuse them often enough to keep growing
+        if (_entries.size() >= MaxEntries)
+            _entries.clear();
+    }
+
+    Entry& entry = _entries[key];
+    entry.Time = now;
+    entry.Path.assign(path, path + length);
+}
+
+void PathCache::RemoveExpired(uint32 now)
+{
+    for (auto itr = _entries.begin(); itr != _entries.end();)
+    {
+        if (getMSTimeDiff(itr->second.Time, now) >= Lifetime)
+            itr = _entries.erase(itr);
+        else
+            ++itr;
+    }
+}
+
+bool PathCache::FindInFlowField(Key const& key, dtQueryFilter const& filter, uint32 now, dtPolyRef* path, uint32& length, uint32 maxLength)
+{
+    Key destinationKey = key;
+    destinationKey.StartPoly = 0;
+
+    auto itr = _destinations.find(destinationKey);
+    if (itr == _destinations.end())
+    {
+        if (_destinations.size() >= MaxEntries)
+        {
+            RemoveExpiredDestinations(now);
+            if (_destinations.size() >= MaxEntries)
+                return false;
+        }
+
+        itr = _destinations.emplace(destinationKey, Destination()).first;
+    }
+
+    Destination& destination = itr->second;
+    if (!destination.Field)
+    {
+        if (getMSTimeDiff(destination.WindowStart, now) >= FlowFieldDemandWindow)
+        {
+            destination.WindowStart = now;
+            destination.Requests = 0;
+        }
+
+        if (++destination.Requests < FlowFieldDemand)
+            return false;
+
+        if (_flowFieldCount >= MaxFlowFields)
+        {
+            RemoveExpiredDestinations(now);
+            if (_flowFieldCount >= MaxFlowFields)
+                return false;
+        }
+
+        std::unique_ptr<FlowField> field = Trinity::make_unique<FlowField>();
+        if (!field->Build(key.NavMesh, key.EndPoly, filter))
+        {
+            // not kept, a new window of demand has to pass before the next attempt
+            destination.WindowStart = now;
+            destination.Requests = 0;
+            return false;
+        }
+
+        destination.Field = std::move(field);
+        ++_flowFieldCount;
+    }
+
+    destination.LastUse = now;
+    if (destination.Field->GetCorridor(key.NavMesh, key.StartPoly, path, length, maxLength))
+        return true;
+
+    // built before a tile reload, drop it - demand builds it again
+    if (destination.Field->IsStale())
+    {
+        destination.Field.reset();
+        destination.Requests = 0;
+        --_flowFieldCount;
+    }
+
+    return false;
+}
+
+void PathCache::RemoveExpiredDestinations(uint32 now)
+{
+    for (auto itr = _destinations.begin(); itr != _destinations.end();)
+    {
+        Destination const& destination = itr->second;
+        bool expired = destination.Field ? getMSTimeDiff(destination.LastUse, now) >= FlowFieldLifetime
+            : getMSTimeDiff(destination.WindowStart, now) >= FlowFieldDemandWindow;
+        if (!expired)
+        {
+            ++itr;
+            continue;
+        }
+
+        if (destination.Field)
+            --_flowFieldCount;
+
+        itr = _destinations.erase(itr);
+    }
+}
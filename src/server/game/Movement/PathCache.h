@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_PATHCACHE_H
+#define TRINITY_PATHCACHE_H
+
+#include "Define.h"
+#include "DetourNavMesh.h"
+#include "FlowField.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class dtQueryFilter;
+
+/*
+ * Short lived cache of the polygon corridors found by PathGenerator.
+ * Units chasing the same target keep searching paths between the same polygons, a fresh corridor
+ * is reused instead of running the A* search again - the point path is still built for each unit.
+ * Destinations many units head to from different places (waves of adds, battleground NPCs) get a
+ * FlowField once requested often enough, any start polygon it reached is then served from it.
+ * Owned by a map and only used from its update thread.
+ */
+class TC_GAME_API PathCache
+{
+public:
+    static uint32 const Lifetime = 500;                     // ms, chase movement recalculates paths about this often
+    static std::size_t const MaxEntries = 1024;
+
+    static uint32 const FlowFieldDemand = 8;                // requests for one destination within FlowFieldDemandWindow ms
+    static uint32 const FlowFieldDemandWindow = 2000;
+    static uint32 const FlowFieldLifetime = 30000;          // ms since the field was last used
+    static std::size_t const MaxFlowFields = 16;
+
+    struct Key
+    {
+        dtNavMesh const* NavMesh;                           // terrain swaps use other meshes on the same map
+        dtPolyRef StartPoly;
+        dtPolyRef EndPoly;
+        uint16 IncludeFlags;
+        uint16 ExcludeFlags;
+
+        bool operator==(Key const& right) const
+        {
+            return NavMesh == right.NavMesh && StartPoly == right.StartPoly && EndPoly == right.EndPoly
+                && IncludeFlags == right.IncludeFlags && ExcludeFlags == right.ExcludeFlags;
+        }
+    };
+
+    PathCache() : _flowFieldCount(0) { }
+
+    // copies a corridor found less than Lifetime ms ago or read from a flow field to path (room for maxLength polygons)
+    bool Find(Key const& key, dtQueryFilter const& filter, dtPolyRef* path, uint32& length, uint32 maxLength);
+    // path must be a complete corridor ending at key.EndPoly, partial results are not cached
+    void Store(Key const& key, dtPolyRef const* path, uint32 length);
+
+private:
+    struct KeyHash
+    {
+        std::size_t operator()(Key const& key) const;
+    };
+
+    struct Entry
+    {
+        uint32 Time;
+        std::vector<dtPolyRef> Path;
+    };
+
+    struct Destination
+    {
+        Destination() : WindowStart(0), Requests(0), LastUse(0) { }
+
+        uint32 WindowStart;
+        uint32 Requests;
+        uint32 LastUse;
+        std::unique_ptr<FlowField> Field;
+    };
+
+    bool FindInFlowField(Key const& key, dtQueryFilter const& filter, uint32 now, dtPolyRef* path, uint32& length, uint32 maxLength);
+    void RemoveExpired(uint32 now);
+    void RemoveExpiredDestinations(uint32 now);
+
+    std::unordered_map<Key, Entry, KeyHash> _entries;
+    std::unordered_map<Key, Destination, KeyHash> _destinations;   // keys without start polygon
+    std::size_t _flowFieldCount;
+};
+
+#endif // TRINITY_PATHCACHE_H
@@ -27,26 +27,23 @@
 #include "MMapManager.h"
 #include "Map.h"
 #include "Metric.h"
+#include "PathCache.h"
 #include "PhasingHandler.h"
 
 ////////////////// PathGenerator //////////////////
 PathGenerator::PathGenerator(const Unit* owner) :
     _polyLength(0), _type(PATHFIND_BLANK), _useStraightPath(false),
     _forceDestination(false), _pointPathLimit(MAX_POINT_PATH_LENGTH), _straightLine(false),
-    _endPosition(G3D::Vector3::zero()), _sourceUnit(owner), _navMesh(NULL),
+    _endPosition(G3D::Vector3::zero()), _sourceUnit(owner), _navMeshMapId(0), _navMesh(NULL),
     _navMeshQuery(NULL)
 {
     memset(_pathPolyRefs, 0, sizeof(_pathPolyRefs));
 
     TC_LOG_DEBUG("maps", "++ PathGenerator::PathGenerator for %s", _sourceUnit->GetGUID().ToString().c_str());
 
-    uint32 mapId = PhasingHandler::GetTerrainMapId(_sourceUnit->GetPhaseShift(), _sourceUnit->GetMap(), _sourceUnit->GetPositionX(), _sourceUnit->GetPositionY());
+    _navMeshMapId = PhasingHandler::GetTerrainMapId(_sourceUnit->GetPhaseShift(), _sourceUnit->GetMap(), _sourceUnit->GetPositionX(), _sourceUnit->GetPositionY());
     if (DisableMgr::IsPathfindingEnabled(_sourceUnit->GetMapId()))
-    {
-        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        _navMesh = mmap->GetNavMesh(mapId);
-        _navMeshQuery = mmap->GetNavMeshQuery(mapId, _sourceUnit->GetInstanceId());
-    }
+        _navMesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(_navMeshMapId);
 
     CreateFilter();
 }
@@ -90,6 +87,10 @@ bool PathGenerator::CalculatePath(G3D::Vector3 start, G3D::Vector3 dest, bool fo
 
     TC_LOG_DEBUG("maps", "++ PathGenerator::CalculatePath() for %s", _sourceUnit->GetGUID().ToString().c_str());
 
+    // maps are not always updated by the same thread, take the query of the current one for every calculation
+    if (_navMesh)
+        _navMeshQuery = MMAP::MMapFactory::createOrGetMMapManager()->GetThreadNavMeshQuery(_navMeshMapId);
+
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
     if (!_navMesh || !_navMeshQuery || _sourceUnit->HasUnitState(UNIT_STATE_IGNORE_PATHFINDING) ||
@@ -457,15 +458,30 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
         }
         else
         {
-            dtResult = _navMeshQuery->findPath(
-                            startPoly,          // start polygon
-                            endPoly,            // end polygon
-                            startPoint,         // start position
-                            endPoint,           // end position
-                            &_filter,           // polygon search filter
-                            _pathPolyRefs,     // [out] path
-                            (int*)&_polyLength,
-                            MAX_PATH_LENGTH);   // max number of polygons in output path
+            // units chasing the same target search the same corridor, reuse one another unit found moments ago
+            // or read it from the flow field of a destination many units are heading to
+            PathCache::Key cacheKey = { _navMesh, startPoly, endPoly, _filter.getIncludeFlags(), _filter.getExcludeFlags() };
+            PathCache& pathCache = _sourceUnit->GetMap()->GetPathCache();
+            if (pathCache.Find(cacheKey, _filter, _pathPolyRefs, _polyLength, MAX_PATH_LENGTH))
+                dtResult = DT_SUCCESS;
+            else
+            {
+                dtResult = _navMeshQuery->findPath(
+                                startPoly,          // start polygon
+                                endPoly,            // end polygon
+                                startPoint,         // start position
+                                endPoint,           // end position
+                                &_filter,           // polygon search filter
+                                _pathPolyRefs,     // [out] path
+                                (int*)&_polyLength,
+                                MAX_PATH_LENGTH);   // max number of polygons in output path
+
+                // only corridors reaching endPoly are shared, a partial one (search out of nodes, path too long)
+                // would be returned by Find as a plain success to units that may well get a full path
+                if (_polyLength && dtStatusSucceed(dtResult) && !dtStatusDetail(dtResult, DT_PARTIAL_RESULT | DT_BUFFER_TOO_SMALL)
+                    && _pathPolyRefs[_polyLength - 1] == endPoly)
+                    pathCache.Store(cacheKey, _pathPolyRefs, _polyLength);
+            }
         }
 
         if (!_polyLength || dtStatusFailed(dtResult))
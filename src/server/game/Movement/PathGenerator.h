@@ -96,8 +96,9 @@ class TC_GAME_API PathGenerator
         G3D::Vector3 _actualEndPosition;    // {x, y, z} of the closest possible point to given destination
 
         Unit const* const _sourceUnit;          // the unit that is moving
+        uint32 _navMeshMapId;                   // terrain map of the nav mesh
         dtNavMesh const* _navMesh;              // the nav mesh
-        dtNavMeshQuery const* _navMeshQuery;    // the nav mesh query used to find the path
+        dtNavMeshQuery const* _navMeshQuery;    // the nav mesh query used to find the path, owned by the calculating thread
 
         dtQueryFilter _filter;  // use single filter for all movements, update it when needed
 
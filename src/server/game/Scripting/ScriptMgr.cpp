@@ -1164,7 +1164,7 @@ ScriptObject::~ScriptObject()
 }
 
 ScriptMgr::ScriptMgr()
-  : _scriptCount(0), _script_loader_callback(nullptr)
+  : _scriptCount(0), _script_loader_callback(nullptr), _hookScriptsChanged(false)
 {
 }
 
@@ -1243,6 +1243,8 @@ void ScriptMgr::SwapScriptContext(bool initialize)
 {
     sScriptRegistryCompositum->SwapContext(initialize);
     _currentContext.clear();
+
+    UpdateHookScripts();
 }
 
 std::string const& ScriptMgr::GetNameOfStaticContext()
@@ -1254,6 +1256,9 @@ std::string const& ScriptMgr::GetNameOfStaticContext()
 void ScriptMgr::ReleaseScriptContext(std::string const& context)
 {
     sScriptRegistryCompositum->ReleaseContext(context);
+
+    // released scripts are already deleted
+    UpdateHookScripts();
 }
 
 std::shared_ptr<ModuleReference>
@@ -1274,11 +1279,52 @@ std::shared_ptr<ModuleReference>
 void ScriptMgr::Unload()
 {
     sScriptRegistryCompositum->Unload();
+    UpdateHookScripts();
 
     delete[] SpellSummary;
     delete[] UnitAI::AISpellInfo;
 }
 
+void ScriptMgr::UpdateHookScripts()
+{
+    _hookScriptsChanged = false;
+
+    for (std::vector<UnitScript*>& scripts : _hookScripts)
+        scripts.clear();
+
+    auto addHooks = [this](UnitScript* script, uint32 lastHook)
+    {
+        uint32 notOverriddenHooks = script->_notOverriddenHooks.load(std::memory_order_relaxed);
+        for (uint32 hook = 0; hook <= lastHook; ++hook)
+            if (!(notOverriddenHooks & (1 << hook)))
+                _hookScripts[hook].push_back(script);
+    };
+
+    // same order as FOREACH_SCRIPT(UnitScript) followed by FOREACH_SCRIPT(PlayerScript)
+    for (auto const& entry : SCR_REG_LST(UnitScript))
+        addHooks(entry.second.get(), SCRIPT_HOOK_MODIFY_SPELL_DAMAGE_TAKEN);
+
+    for (auto const& entry : SCR_REG_LST(PlayerScript))
+        addHooks(entry.second.get(), SCRIPT_HOOK_PLAYER_ON_UPDATE);
+
+    // OnMapUpdate runs for every map on every tick, don't look the map script up in the whole registry
+    _mapUpdateScripts.clear();
+    for (auto const& entry : SCR_REG_LST(WorldMapScript))
+        if (MapEntry const* mapEntry = entry.second->GetEntry())
+            if (!_mapUpdateScripts[mapEntry->ID].World)
+                _mapUpdateScripts[mapEntry->ID].World = entry.second.get();
+
+    for (auto const& entry : SCR_REG_LST(InstanceMapScript))
+        if (MapEntry const* mapEntry = entry.second->GetEntry())
+            if (!_mapUpdateScripts[mapEntry->ID].Instance)
+                _mapUpdateScripts[mapEntry->ID].Instance = entry.second.get();
+
+    for (auto const& entry : SCR_REG_LST(BattlegroundMapScript))
+        if (MapEntry const* mapEntry = entry.second->GetEntry())
+            if (!_mapUpdateScripts[mapEntry->ID].Battleground)
+                _mapUpdateScripts[mapEntry->ID].Battleground = entry.second.get();
+}
+
 void ScriptMgr::LoadDatabase()
 {
     sScriptSystemMgr->LoadScriptWaypoints();
@@ -1490,6 +1536,10 @@ void ScriptMgr::OnShutdownCancel()
 
 void ScriptMgr::OnWorldUpdate(uint32 diff)
 {
+    // called after the maps are updated, nothing dispatches the hooks concurrently
+    if (_hookScriptsChanged)
+        UpdateHookScripts();
+
     FOREACH_SCRIPT(WorldScript)->OnUpdate(diff);
 }
 
@@ -1660,17 +1710,20 @@ void ScriptMgr::OnMapUpdate(Map* map, uint32 diff)
 {
     ASSERT(map);
 
-    SCR_MAP_BGN(WorldMapScript, map, itr, end, entry, IsWorldMap);
-        itr->second->OnUpdate(map, diff);
-    SCR_MAP_END;
+    MapEntry const* mapEntry = map->GetEntry();
+    if (!mapEntry)
+        return;
 
-    SCR_MAP_BGN(InstanceMapScript, map, itr, end, entry, IsDungeon);
-        itr->second->OnUpdate((InstanceMap*)map, diff);
-    SCR_MAP_END;
+    auto itr = _mapUpdateScripts.find(map->GetId());
+    if (itr == _mapUpdateScripts.end())
+        return;
 
-    SCR_MAP_BGN(BattlegroundMapScript, map, itr, end, entry, IsBattleground);
-        itr->second->OnUpdate((BattlegroundMap*)map, diff);
-    SCR_MAP_END;
+    if (mapEntry->IsWorldMap() && itr->second.World)
+        itr->second.World->OnUpdate(map, diff);
+    else if (mapEntry->IsDungeon() && itr->second.Instance)
+        itr->second.Instance->OnUpdate((InstanceMap*)map, diff);
+    else if (mapEntry->IsBattleground() && itr->second.Battleground)
+        itr->second.Battleground->OnUpdate((BattlegroundMap*)map, diff);
 }
 
 #undef SCR_MAP_BGN
@@ -2336,7 +2389,8 @@ void ScriptMgr::OnPlayerLogin(Player* player, bool firstLogin)
 
 void ScriptMgr::OnPlayerUpdate(Player* player, uint32 diff)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnUpdate(player, diff);
+    for (UnitScript* script : _hookScripts[SCRIPT_HOOK_PLAYER_ON_UPDATE])
+        static_cast<PlayerScript*>(script)->OnUpdate(player, diff);
 }
 
 void ScriptMgr::OnPlayerLogout(Player* player)
@@ -2596,32 +2650,32 @@ void ScriptMgr::OnGroupDisband(Group* group)
 // Unit
 void ScriptMgr::OnHeal(Unit* healer, Unit* reciever, uint32& gain)
 {
-    FOREACH_SCRIPT(UnitScript)->OnHeal(healer, reciever, gain);
-    FOREACH_SCRIPT(PlayerScript)->OnHeal(healer, reciever, gain);
+    for (UnitScript* script : _hookScripts[SCRIPT_HOOK_ON_HEAL])
+        script->OnHeal(healer, reciever, gain);
 }
 
 void ScriptMgr::OnDamage(Unit* attacker, Unit* victim, uint32& damage, SpellInfo const* spellProto)
 {
-    FOREACH_SCRIPT(UnitScript)->OnDamage(attacker, victim, damage, spellProto);
-    FOREACH_SCRIPT(PlayerScript)->OnDamage(attacker, victim, damage, spellProto);
+    for (UnitScript* script : _hookScripts[SCRIPT_HOOK_ON_DAMAGE])
+        script->OnDamage(attacker, victim, damage, spellProto);
 }
 
 void ScriptMgr::ModifyPeriodicDamageAurasTick(Unit* target, Unit* attacker, uint32& damage)
 {
-    FOREACH_SCRIPT(UnitScript)->ModifyPeriodicDamageAurasTick(target, attacker, damage);
-    FOREACH_SCRIPT(PlayerScript)->ModifyPeriodicDamageAurasTick(target, attacker, damage);
+    for (UnitScript* script : _hookScripts[SCRIPT_HOOK_MODIFY_PERIODIC_DAMAGE_AURAS_TICK])
+        script->ModifyPeriodicDamageAurasTick(target, attacker, damage);
 }
 
 void ScriptMgr::ModifyMeleeDamage(Unit* target, Unit* attacker, uint32& damage)
 {
-    FOREACH_SCRIPT(UnitScript)->ModifyMeleeDamage(target, attacker, damage);
-    FOREACH_SCRIPT(PlayerScript)->ModifyMeleeDamage(target, attacker, damage);
+    for (UnitScript* script : _hookScripts[SCRIPT_HOOK_MODIFY_MELEE_DAMAGE])
+        script->ModifyMeleeDamage(target, attacker, damage);
 }
 
 void ScriptMgr::ModifySpellDamageTaken(Unit* target, Unit* attacker, int32& damage, SpellInfo const* spellInfo)
 {
-    FOREACH_SCRIPT(UnitScript)->ModifySpellDamageTaken(target, attacker, damage, spellInfo);
-    FOREACH_SCRIPT(PlayerScript)->ModifySpellDamageTaken(target, attacker, damage, spellInfo);
+    for (UnitScript* script : _hookScripts[SCRIPT_HOOK_MODIFY_SPELL_DAMAGE_TAKEN])
+        script->ModifySpellDamageTaken(target, attacker, damage, spellInfo);
 }
 
 // Conversation
@@ -2715,12 +2769,23 @@ FormulaScript::FormulaScript(const char* name)
 }
 
 UnitScript::UnitScript(const char* name, bool addToScripts)
-    : ScriptObject(name)
+    : ScriptObject(name), _notOverriddenHooks(0)
 {
     if (addToScripts)
         ScriptRegistry<UnitScript>::Instance()->AddScript(this);
 }
 
+void UnitScript::SetHookNotOverridden(ScriptHookType hook)
+{
+    uint32 const mask = 1 << hook;
+    if (_notOverriddenHooks.load(std::memory_order_relaxed) & mask)
+        return;
+
+    // picked up by the next ScriptMgr::OnWorldUpdate
+    _notOverriddenHooks.fetch_or(mask, std::memory_order_relaxed);
+    sScriptMgr->_hookScriptsChanged = true;
+}
+
 WorldMapScript::WorldMapScript(const char* name, uint32 mapId)
     : ScriptObject(name), MapScript<Map>(sMapStore.LookupEntry(mapId))
 {
@@ -21,6 +21,9 @@
 
 #include "Common.h"
 #include "ObjectGuid.h"
+#include <array>
+#include <atomic>
+#include <unordered_map>
 #include <vector>
 #include <boost/property_tree/ptree.hpp>
 
@@ -96,6 +99,18 @@ enum XPColorChar : uint8;
 
 #define VISIBLE_RANGE       166.0f                          //MAX visible range (size of grid)
 
+// Hooks called often enough that ScriptMgr only dispatches them to the scripts overriding them
+enum ScriptHookType
+{
+    SCRIPT_HOOK_ON_HEAL,
+    SCRIPT_HOOK_ON_DAMAGE,
+    SCRIPT_HOOK_MODIFY_PERIODIC_DAMAGE_AURAS_TICK,
+    SCRIPT_HOOK_MODIFY_MELEE_DAMAGE,
+    SCRIPT_HOOK_MODIFY_SPELL_DAMAGE_TAKEN,
+    SCRIPT_HOOK_PLAYER_ON_UPDATE,
+    MAX_SCRIPT_HOOKS
+};
+
 
 /*
     @todo Add more script type classes.
@@ -400,25 +415,36 @@ class TC_GAME_API ItemScript : public ScriptObject
 
 class TC_GAME_API UnitScript : public ScriptObject
 {
+    friend class ScriptMgr;
+
     protected:
 
         UnitScript(const char* name, bool addToScripts = true);
 
+        // The default implementations of the ScriptHookType hooks report that they were reached,
+        // ScriptMgr then stops dispatching the hook to this script.
+        // Overrides of these hooks must not call the base implementation.
+        void SetHookNotOverridden(ScriptHookType hook);
+
     public:
         // Called when a unit deals healing to another unit
-        virtual void OnHeal(Unit* /*healer*/, Unit* /*reciever*/, uint32& /*gain*/) { }
+        virtual void OnHeal(Unit* /*healer*/, Unit* /*reciever*/, uint32& /*gain*/) { SetHookNotOverridden(SCRIPT_HOOK_ON_HEAL); }
 
         // Called when a unit deals damage to another unit
-        virtual void OnDamage(Unit* /*attacker*/, Unit* /*victim*/, uint32& /*damage*/, SpellInfo const* /*spellProto*/) { }
+        virtual void OnDamage(Unit* /*attacker*/, Unit* /*victim*/, uint32& /*damage*/, SpellInfo const* /*spellProto*/) { SetHookNotOverridden(SCRIPT_HOOK_ON_DAMAGE); }
 
         // Called when DoT's Tick Damage is being Dealt
-        virtual void ModifyPeriodicDamageAurasTick(Unit* /*target*/, Unit* /*attacker*/, uint32& /*damage*/) { }
+        virtual void ModifyPeriodicDamageAurasTick(Unit* /*target*/, Unit* /*attacker*/, uint32& /*damage*/) { SetHookNotOverridden(SCRIPT_HOOK_MODIFY_PERIODIC_DAMAGE_AURAS_TICK); }
 
         // Called when Melee Damage is being Dealt
-        virtual void ModifyMeleeDamage(Unit* /*target*/, Unit* /*attacker*/, uint32& /*damage*/) { }
+        virtual void ModifyMeleeDamage(Unit* /*target*/, Unit* /*attacker*/, uint32& /*damage*/) { SetHookNotOverridden(SCRIPT_HOOK_MODIFY_MELEE_DAMAGE); }
 
         // Called when Spell Damage is being Dealt
-        virtual void ModifySpellDamageTaken(Unit* /*target*/, Unit* /*attacker*/, int32& /*damage*/, SpellInfo const* /*spellInfo*/) { }
+        virtual void ModifySpellDamageTaken(Unit* /*target*/, Unit* /*attacker*/, int32& /*damage*/, SpellInfo const* /*spellInfo*/) { SetHookNotOverridden(SCRIPT_HOOK_MODIFY_SPELL_DAMAGE_TAKEN); }
+
+    private:
+
+        std::atomic<uint32> _notOverriddenHooks;            // mask of ScriptHookType, written from the map update threads
 };
 
 class TC_GAME_API CreatureScript : public UnitScript, public UpdatableScript<Creature>
@@ -744,7 +770,7 @@ class TC_GAME_API PlayerScript : public UnitScript
         virtual void OnLogin(Player* /*player*/, bool /*firstLogin*/) { }
 
         // Called at each player update
-        virtual void OnUpdate(Player* /*player*/, uint32 /*diff*/) { }
+        virtual void OnUpdate(Player* /*player*/, uint32 /*diff*/) { SetHookNotOverridden(SCRIPT_HOOK_PLAYER_ON_UPDATE); }
 
         // Called when a player logs out.
         virtual void OnLogout(Player* /*player*/) { }
@@ -1004,6 +1030,7 @@ class TC_GAME_API QuestScript : public ScriptObject
 class TC_GAME_API ScriptMgr
 {
     friend class ScriptObject;
+    friend class UnitScript;
 
     private:
         ScriptMgr();
@@ -1329,11 +1356,26 @@ class TC_GAME_API ScriptMgr
         ZoneScript* GetZoneScript(uint32 scriptId);
 
     private:
+        void UpdateHookScripts();
+
         uint32 _scriptCount;
 
         ScriptLoaderCallbackType _script_loader_callback;
 
         std::string _currentContext;
+
+        // UnitScripts and PlayerScripts overriding each ScriptHookType, in dispatch order
+        std::array<std::vector<UnitScript*>, MAX_SCRIPT_HOOKS> _hookScripts;
+        std::atomic<bool> _hookScriptsChanged;              // a script reached a default hook implementation
+
+        // first world, instance and battleground map script of each map id
+        struct MapUpdateScripts
+        {
+            WorldMapScript* World = nullptr;
+            InstanceMapScript* Instance = nullptr;
+            BattlegroundMapScript* Battleground = nullptr;
+        };
+        std::unordered_map<uint32, MapUpdateScripts> _mapUpdateScripts;
 };
 
 template <class S>
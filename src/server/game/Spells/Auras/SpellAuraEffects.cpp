@@ -31,6 +31,7 @@
 #include "MotionMaster.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
+#include "ObjectPool.h"
 #include "Opcodes.h"
 #include "OutdoorPvPMgr.h"
 #include "Pet.h"
@@ -560,6 +561,16 @@ pAuraEffectHandler AuraEffectHandler[TOTAL_AURAS]=
     &AuraEffect::HandleNoImmediateEffect,                         //491 SPELL_AURA_MOD_HONOR_GAIN_PCT_2 implemented in Player::RewardHonor
 };
 
+void* AuraEffect::operator new(std::size_t size)
+{
+    return Trinity::ObjectPool<AuraEffect>::Allocate(size);
+}
+
+void AuraEffect::operator delete(void* ptr, std::size_t size)
+{
+    Trinity::ObjectPool<AuraEffect>::Deallocate(ptr, size);
+}
+
 AuraEffect::AuraEffect(Aura* base, uint32 effIndex, int32 *baseAmount, Unit* caster) :
 m_base(base), m_spellInfo(base->GetSpellInfo()),
 _effectInfo(base->GetSpellEffectInfo(effIndex)),
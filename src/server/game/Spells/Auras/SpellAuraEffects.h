@@ -38,6 +38,9 @@ class TC_GAME_API AuraEffect
 
         ~AuraEffect();
         AuraEffect(Aura* base, uint32 effIndex, int32 *baseAmount, Unit* caster);
+
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
         Unit* GetCaster() const { return GetBase()->GetCaster(); }
         ObjectGuid GetCasterGUID() const { return GetBase()->GetCasterGUID(); }
         Aura* GetBase() const { return m_base; }
@@ -26,6 +26,7 @@
 #include "Log.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
+#include "ObjectPool.h"
 #include "Player.h"
 #include "ScriptMgr.h"
 #include "Spell.h"
@@ -39,6 +40,16 @@
 #include "Vehicle.h"
 #include "World.h"
 
+void* AuraApplication::operator new(std::size_t size)
+{
+    return Trinity::ObjectPool<AuraApplication>::Allocate(size);
+}
+
+void AuraApplication::operator delete(void* ptr, std::size_t size)
+{
+    Trinity::ObjectPool<AuraApplication>::Deallocate(ptr, size);
+}
+
 AuraApplication::AuraApplication(Unit* target, Unit* caster, Aura* aura, uint32 effMask):
 _target(target), _base(aura), _removeMode(AURA_REMOVE_NONE), _slot(MAX_AURAS),
 _flags(AFLAG_NONE), _effectsToApply(effMask), _needClientUpdate(false), _effectMask(0)
@@ -359,6 +370,16 @@ Aura* Aura::Create(SpellInfo const* spellproto, ObjectGuid castId, uint32 effMas
     return aura;
 }
 
+void* Aura::operator new(std::size_t size)
+{
+    return Trinity::ObjectPool<Aura>::Allocate(size);
+}
+
+void Aura::operator delete(void* ptr, std::size_t size)
+{
+    Trinity::ObjectPool<Aura>::Deallocate(ptr, size);
+}
+
 Aura::Aura(SpellInfo const* spellproto, ObjectGuid castId, WorldObject* owner, Unit* caster, Item* castItem, ObjectGuid casterGUID, ObjectGuid castItemGuid, int32 castItemLevel) :
 m_spellInfo(spellproto), m_castGuid(castId), m_casterGuid(!casterGUID.IsEmpty() ? casterGUID : caster->GetGUID()),
 m_castItemGuid(castItem ? castItem->GetGUID() : castItemGuid), m_castItemLevel(castItemLevel), m_spellXSpellVisualId(caster ? caster->GetCastSpellXSpellVisualId(spellproto) : spellproto->GetSpellXSpellVisualId()),
@@ -70,6 +70,8 @@ class TC_GAME_API AuraApplication
         void _InitFlags(Unit* caster, uint32 effMask);
         void _HandleEffect(uint8 effIndex, bool apply);
     public:
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
 
         Unit* GetTarget() const { return _target; }
         Aura* GetBase() const { return _base; }
@@ -130,6 +132,9 @@ class TC_GAME_API Aura
         void _InitEffects(uint32 effMask, Unit* caster, int32 *baseAmount);
         virtual ~Aura();
 
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
+
         SpellInfo const* GetSpellInfo() const { return m_spellInfo; }
         uint32 GetId() const{ return GetSpellInfo()->Id; }
 
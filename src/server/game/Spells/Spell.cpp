@@ -37,6 +37,7 @@
 #include "LootMgr.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
+#include "ObjectPool.h"
 #include "PathGenerator.h"
 #include "Pet.h"
 #include "Player.h"
@@ -552,6 +553,9 @@ public:
     SpellEvent(Spell* spell);
     virtual ~SpellEvent();
 
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr, std::size_t size);
+
     virtual bool Execute(uint64 e_time, uint32 p_time) override;
     virtual void Abort(uint64 e_time) override;
     virtual bool IsDeletable() const override;
@@ -559,6 +563,16 @@ protected:
     Spell* m_Spell;
 };
 
+void* Spell::operator new(std::size_t size)
+{
+    return Trinity::ObjectPool<Spell>::Allocate(size);
+}
+
+void Spell::operator delete(void* ptr, std::size_t size)
+{
+    Trinity::ObjectPool<Spell>::Deallocate(ptr, size);
+}
+
 Spell::Spell(Unit* caster, SpellInfo const* info, TriggerCastFlags triggerFlags, ObjectGuid originalCasterGUID, bool skipCheck) :
 m_spellInfo(info), m_caster((info->HasAttribute(SPELL_ATTR6_CAST_BY_CHARMER) && caster->GetCharmerOrOwner()) ? caster->GetCharmerOrOwner() : caster),
 m_spellValue(new SpellValue(caster->GetMap()->GetDifficultyID(), m_spellInfo))
@@ -7244,6 +7258,16 @@ bool Spell::HaveTargetsForEffect(uint8 effect) const
     return false;
 }
 
+void* SpellEvent::operator new(std::size_t size)
+{
+    return Trinity::ObjectPool<SpellEvent>::Allocate(size);
+}
+
+void SpellEvent::operator delete(void* ptr, std::size_t size)
+{
+    Trinity::ObjectPool<SpellEvent>::Deallocate(ptr, size);
+}
+
 SpellEvent::SpellEvent(Spell* spell) : BasicEvent()
 {
     m_Spell = spell;
@@ -332,6 +332,9 @@ class TC_GAME_API Spell
     friend void SetUnitCurrentCastSpell(Unit* unit, Spell* spell);
     friend class SpellScript;
     public:
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
+
         Ashamane::AnyData Variables;
 
         void EffectNULL(SpellEffIndex effIndex);
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SpellBenchmark.h"
+#include "Creature.h"
+#include "Log.h"
+#include "Map.h"
+#include "MapManager.h"
+#include "ObjectPool.h"
+#include "Random.h"
+#include "Spell.h"
+#include "SpellAuraEffects.h"
+#include "SpellAuras.h"
+#include "SpellInfo.h"
+#include "SpellMgr.h"
+#include "TemporarySummon.h"
+#include <chrono>
+
+namespace
+{
+    uint32 const BENCHMARK_FACTION_CASTERS = 1;             // Alliance player faction
+    uint32 const BENCHMARK_FACTION_TARGETS = 14;            // Monster, hostile to everyone
+    uint64 const BENCHMARK_TARGET_HEALTH   = 1000000000;
+
+    struct PoolSnapshot
+    {
+        PoolSnapshot()
+        {
+            Trinity::ObjectPool<Spell>::FlushThreadStats();
+            Trinity::ObjectPool<Aura>::FlushThreadStats();
+            Trinity::ObjectPool<AuraApplication>::FlushThreadStats();
+            Trinity::ObjectPool<AuraEffect>::FlushThreadStats();
+
+            SpellsAllocated = Trinity::ObjectPool<Spell>::GetStats().Allocated.load();
+            SpellsReused = Trinity::ObjectPool<Spell>::GetStats().Reused.load();
+            AurasAllocated = Trinity::ObjectPool<Aura>::GetStats().Allocated.load() + Trinity::ObjectPool<AuraApplication>::GetStats().Allocated.load() + Trinity::ObjectPool<AuraEffect>::GetStats().Allocated.load();
+            AurasReused = Trinity::ObjectPool<Aura>::GetStats().Reused.load() + Trinity::ObjectPool<AuraApplication>::GetStats().Reused.load() + Trinity::ObjectPool<AuraEffect>::GetStats().Reused.load();
+        }
+
+        uint64 SpellsAllocated;
+        uint64 SpellsReused;
+        uint64 AurasAllocated;
+        uint64 AurasReused;
+    };
+
+    // private instance of a world map that never loads the database spawns of its grids,
+    // only the synthetic creatures of the benchmark are on it
+    class BenchmarkMap : public Map
+    {
+        public:
+            using Map::Map;
+
+        protected:
+            void LoadGridObjects(NGridType* /*grid*/, Cell const& /*cell*/) override { }
+    };
+
+    uint64 GetMicrosecondsSince(std::chrono::steady_clock::time_point const& start)
+    {
+        return uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    TempSummon* SummonBenchmarkCreature(Map* map, Position const& center, uint32 entry, uint32 index, uint32 count, float radius, uint32 faction)
+    {
+        // spread the creatures evenly on a circle so every run places them at the same spot
+        float angle = 2.0f * float(M_PI) * float(index) / float(count);
+        Position pos(center.GetPositionX() + radius * std::cos(angle), center.GetPositionY() + radius * std::sin(angle), center.GetPositionZ(), angle + float(M_PI));
+
+        TempSummon* summon = map->SummonCreature(entry, pos);
+        if (!summon)
+            return nullptr;
+
+        summon->setFaction(faction);
+        summon->SetReactState(REACT_PASSIVE);
+        summon->AddUnitState(UNIT_STATE_ROOT);
+        summon->setActive(true);                            // updated by Map::Update without any player around
+        return summon;
+    }
+
+    void DestroyBenchmarkMap(Map* map)
+    {
+        map->UnloadAll();
+
+        uint32 instanceId = map->GetInstanceId();
+        delete map;
+        sMapMgr->FreeInstanceId(instanceId);
+    }
+}
+
+bool SpellBenchmark::Run(uint32 mapId, Position const& center, SpellBenchmarkParams const& params, SpellBenchmarkResult& result)
+{
+    if (params.SpellIds.empty() || !params.CasterCount || !params.TargetCount)
+        return false;
+
+    MapEntry const* mapEntry = sMapStore.LookupEntry(mapId);
+    if (!mapEntry || !mapEntry->IsWorldMap())
+    {
+        TC_LOG_ERROR("misc", "SpellBenchmark: map %u is not a world map.", mapId);
+        return false;
+    }
+
+    std::vector<SpellInfo const*> spells;
+    for (uint32 spellId : params.SpellIds)
+    {
+        SpellInfo const* spellInfo = sSpellMgr->GetSpellInfo(spellId);
+        if (!spellInfo)
+        {
+            TC_LOG_ERROR("misc", "SpellBenchmark: spell %u does not exist.", spellId);
+            return false;
+        }
+
+        spells.push_back(spellInfo);
+    }
+
+    std::chrono::steady_clock::time_point phaseStart = std::chrono::steady_clock::now();
+
+    RandomSeedScope seed(params.Seed);
+
+    // a private instance of the map, sharing the terrain of the base map: players and spawns of the live map are not touched
+    // and the grids only get terrain, the database creatures and gameobjects placed there are never loaded
+    Map* baseMap = sMapMgr->CreateBaseMap(mapId);
+    uint32 instanceId = sMapMgr->GenerateInstanceId();
+    Map* map = new BenchmarkMap(mapId, baseMap->GetGridExpiry(), instanceId, DIFFICULTY_NONE, baseMap);
+    map->LoadGrid(center.GetPositionX(), center.GetPositionY());
+
+    std::vector<TempSummon*> casters;
+    std::vector<TempSummon*> targets;
+    for (uint32 i = 0; i < params.CasterCount; ++i)
+        if (TempSummon* caster = SummonBenchmarkCreature(map, center, params.CreatureEntry, i, params.CasterCount, 5.0f, BENCHMARK_FACTION_CASTERS))
+            casters.push_back(caster);
+
+    for (uint32 i = 0; i < params.TargetCount; ++i)
+    {
+        if (TempSummon* target = SummonBenchmarkCreature(map, center, params.CreatureEntry, i, params.TargetCount, 10.0f, BENCHMARK_FACTION_TARGETS))
+        {
+            target->SetMaxHealth(BENCHMARK_TARGET_HEALTH);
+            target->SetFullHealth();
+            targets.push_back(target);
+        }
+    }
+
+    if (casters.size() != params.CasterCount || targets.size() != params.TargetCount)
+    {
+        TC_LOG_ERROR("misc", "SpellBenchmark: could not summon creature %u on map %u.", params.CreatureEntry, mapId);
+        DestroyBenchmarkMap(map);
+        return false;
+    }
+
+    result.SetupTime = GetMicrosecondsSince(phaseStart);
+
+    PoolSnapshot poolsBefore;
+
+    for (uint32 tick = 0; tick < params.Ticks; ++tick)
+    {
+        phaseStart = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < casters.size(); ++i)
+        {
+            SpellInfo const* spellInfo = spells[(tick + i) % spells.size()];
+
+            // helpful spells go to the other casters, harmful ones to the hostile targets
+            Unit* target = spellInfo->IsPositive() ? static_cast<Unit*>(casters[urand(0, uint32(casters.size() - 1))]) : static_cast<Unit*>(targets[urand(0, uint32(targets.size() - 1))]);
+            if (casters[i]->CastSpell(target, spellInfo, TRIGGERED_FULL_MASK))
+                ++result.Casts;
+            else
+                ++result.FailedCasts;
+        }
+        result.CastTime += GetMicrosecondsSince(phaseStart);
+
+        phaseStart = std::chrono::steady_clock::now();
+        map->Update(params.TickDiff);
+        result.UpdateTime += GetMicrosecondsSince(phaseStart);
+
+        for (TempSummon* target : targets)
+            target->SetFullHealth();
+    }
+
+    PoolSnapshot poolsAfter;
+    result.SpellsAllocated = poolsAfter.SpellsAllocated - poolsBefore.SpellsAllocated;
+    result.SpellsReused = poolsAfter.SpellsReused - poolsBefore.SpellsReused;
+    result.AurasAllocated = poolsAfter.AurasAllocated - poolsBefore.AurasAllocated;
+    result.AurasReused = poolsAfter.AurasReused - poolsBefore.AurasReused;
+
+    DestroyBenchmarkMap(map);
+    return true;
+}
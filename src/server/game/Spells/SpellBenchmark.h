@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_SPELLBENCHMARK_H
+#define TRINITY_SPELLBENCHMARK_H
+
+#include "Define.h"
+#include "Position.h"
+#include <vector>
+
+struct SpellBenchmarkParams
+{
+    SpellBenchmarkParams() : CreatureEntry(31144), CasterCount(20), TargetCount(20), Ticks(600), TickDiff(100), Seed(0) { }
+
+    std::vector<uint32> SpellIds;                           // cast in turn by every caster, one cast per caster per tick
+    uint32 CreatureEntry;                                   // template used for casters and targets (default: Training Dummy)
+    uint32 CasterCount;
+    uint32 TargetCount;
+    uint32 Ticks;
+    uint32 TickDiff;                                        // simulated time per map update (ms)
+    uint32 Seed;
+};
+
+struct SpellBenchmarkResult
+{
+    SpellBenchmarkResult() : Casts(0), FailedCasts(0), SetupTime(0), CastTime(0), UpdateTime(0),
+        SpellsAllocated(0), SpellsReused(0), AurasAllocated(0), AurasReused(0) { }
+
+    uint32 Casts;
+    uint32 FailedCasts;
+
+    // wall clock time per phase, in microseconds
+    uint64 SetupTime;
+    uint64 CastTime;                                        // Unit::CastSpell calls
+    uint64 UpdateTime;                                      // Map::Update (spell events, aura ticks, procs...)
+
+    // allocations done through the spell and aura object pools during the run
+    uint64 SpellsAllocated;
+    uint64 SpellsReused;
+    uint64 AurasAllocated;
+    uint64 AurasReused;
+};
+
+/*
+ * Replays a deterministic cast sequence between synthetic creatures, driving Map::Update directly.
+ * The run happens on a private copy of the map without players nor database spawns, destroyed afterwards.
+ * Must be called from the world thread while maps are not being updated (console commands).
+ */
+class TC_GAME_API SpellBenchmark
+{
+public:
+    static bool Run(uint32 mapId, Position const& center, SpellBenchmarkParams const& params, SpellBenchmarkResult& result);
+};
+
+#endif // TRINITY_SPELLBENCHMARK_H
@@ -41,12 +41,14 @@
 #include "ChatPackets.h"
 #include "Config.h"
 #include "ConversationDataStore.h"
+#include "Creature.h"
 #include "CreatureAIRegistry.h"
 #include "CreatureGroups.h"
 #include "CreatureTextMgr.h"
 #include "DatabaseEnv.h"
 #include "DisableMgr.h"
 #include "GameEventMgr.h"
+#include "GameObject.h"
 #include "GameObjectModel.h"
 #include "GameTables.h"
 #include "GarrisonMgr.h"
@@ -69,6 +71,7 @@
 #include "Object.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
+#include "ObjectPool.h"
 #include "OutdoorPvPMgr.h"
 #include "Player.h"
 #include "PlayerDump.h"
@@ -79,6 +82,9 @@
 #include "ScriptReloadMgr.h"
 #include "SkillDiscovery.h"
 #include "SkillExtraItems.h"
+#include "Spell.h"
+#include "SpellAuraEffects.h"
+#include "SpellAuras.h"
 #include "SpellMgr.h"
 #include "SmartScriptMgr.h"
 #include "SupportMgr.h"
@@ -1202,6 +1208,15 @@ void World::LoadConfigSettings(bool reload)
     m_int_configs[CONFIG_CREATURE_PICKPOCKET_REFILL] = sConfigMgr->GetIntDefault("Creature.PickPocketRefillDelay", 10 * MINUTE);
     m_int_configs[CONFIG_CREATURE_STOP_FOR_PLAYER] = sConfigMgr->GetIntDefault("Creature.MovingStopTimeForPlayer", 3 * MINUTE * IN_MILLISECONDS);
 
+    m_float_configs[CONFIG_CREATURE_AI_UPDATE_LOD_DISTANCE] = sConfigMgr->GetFloatDefault("Creature.AIUpdateLOD.Distance", 0.0f);
+    if (m_float_configs[CONFIG_CREATURE_AI_UPDATE_LOD_DISTANCE] < 0.0f)
+    {
+        TC_LOG_ERROR("server.loading", "Creature.AIUpdateLOD.Distance (%f) must be >= 0. Using 0 instead.", m_float_configs[CONFIG_CREATURE_AI_UPDATE_LOD_DISTANCE]);
+        m_float_configs[CONFIG_CREATURE_AI_UPDATE_LOD_DISTANCE] = 0.0f;
+    }
+
+    m_int_configs[CONFIG_CREATURE_AI_UPDATE_LOD_INTERVAL] = sConfigMgr->GetIntDefault("Creature.AIUpdateLOD.Interval", 1000);
+
     if (int32 clientCacheId = sConfigMgr->GetIntDefault("ClientCacheVersion", 0))
     {
         // overwrite DB/old value
@@ -1332,6 +1347,7 @@ void World::LoadConfigSettings(bool reload)
 
     m_bool_configs[CONFIG_ENABLE_MMAPS] = sConfigMgr->GetBoolDefault("mmap.enablePathFinding", false);
     TC_LOG_INFO("server.loading", "WORLD: MMap data directory is: %smmaps", m_dataPath.c_str());
+    MMAP::MMapFactory::createOrGetMMapManager()->setTileMemoryLimit(uint64(sConfigMgr->GetIntDefault("mmap.tileMemoryLimit", 0)) * 1024 * 1024);
 
     m_bool_configs[CONFIG_VMAP_INDOOR_CHECK] = sConfigMgr->GetBoolDefault("vmap.enableIndoorCheck", 0);
     bool enableIndoor = sConfigMgr->GetBoolDefault("vmap.enableIndoorCheck", true);
@@ -1343,6 +1359,8 @@ void World::LoadConfigSettings(bool reload)
 
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableLineOfSightCalc(enableLOS);
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableHeightCalc(enableHeight);
+    if (VMAP::VMapManager2* vmmgr2 = dynamic_cast<VMAP::VMapManager2*>(VMAP::VMapFactory::createOrGetVMapManager()))
+        vmmgr2->setIdleModelMemoryLimit(std::size_t(sConfigMgr->GetIntDefault("vmap.idleModelCacheMemory", 0)) * 1024 * 1024);
     TC_LOG_INFO("server.loading", "VMap support included. LineOfSight: %i, getHeight: %i, indoorCheck: %i", enableLOS, enableHeight, enableIndoor);
     TC_LOG_INFO("server.loading", "VMap data directory is: %svmaps", m_dataPath.c_str());
 
@@ -1371,6 +1389,9 @@ void World::LoadConfigSettings(bool reload)
     m_int_configs[CONFIG_INTERVAL_LOG_UPDATE] = sConfigMgr->GetIntDefault("RecordUpdateTimeDiffInterval", 60000);
     m_int_configs[CONFIG_MIN_LOG_UPDATE] = sConfigMgr->GetIntDefault("MinRecordUpdateTimeDiff", 100);
     m_int_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 1);
+    m_int_configs[CONFIG_GRID_PRELOAD_THREADS] = sConfigMgr->GetIntDefault("MapUpdate.GridPreload.Threads", 1);
+    m_int_configs[CONFIG_GRID_PRELOAD_LOOKAHEAD] = sConfigMgr->GetIntDefault("MapUpdate.GridPreload.LookAhead", 10000);
+    m_int_configs[CONFIG_DB2_LOAD_THREADS] = sConfigMgr->GetIntDefault("DataStores.LoadThreads", 4);
     m_int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = sConfigMgr->GetIntDefault("Command.LookupMaxResults", 0);
 
     // Warden
@@ -1574,7 +1595,7 @@ void World::SetInitialWorldSettings()
 
     TC_LOG_INFO("server.loading", "Initialize data stores...");
     ///- Load DB2s
-    sDB2Manager.LoadStores(m_dataPath, m_defaultDbcLocale);
+    sDB2Manager.LoadStores(m_dataPath, m_defaultDbcLocale, getIntConfig(CONFIG_DB2_LOAD_THREADS));
     TC_LOG_INFO("misc", "Loading hotfix info...");
     sDB2Manager.LoadHotfixData();
     ///- Close hotfix database - it is only used during DB2 loading
@@ -2552,6 +2573,20 @@ void World::Update(uint32 diff)
     // Stats logger update
     sMetric->Update();
     TC_METRIC_VALUE("update_time_diff", diff);
+    TC_METRIC_VALUE("spell_pool_allocated", Trinity::ObjectPool<Spell>::GetStats().Allocated.load());
+    TC_METRIC_VALUE("spell_pool_reused", Trinity::ObjectPool<Spell>::GetStats().Reused.load());
+    TC_METRIC_VALUE("aura_pool_allocated", Trinity::ObjectPool<Aura>::GetStats().Allocated.load() + Trinity::ObjectPool<AuraApplication>::GetStats().Allocated.load() + Trinity::ObjectPool<AuraEffect>::GetStats().Allocated.load());
+    TC_METRIC_VALUE("aura_pool_reused", Trinity::ObjectPool<Aura>::GetStats().Reused.load() + Trinity::ObjectPool<AuraApplication>::GetStats().Reused.load() + Trinity::ObjectPool<AuraEffect>::GetStats().Reused.load());
+    TC_METRIC_VALUE("creature_pool_allocated", (Trinity::ObjectPool<Creature, 256>::GetStats().Allocated.load()));
+    TC_METRIC_VALUE("creature_pool_reused", (Trinity::ObjectPool<Creature, 256>::GetStats().Reused.load()));
+    TC_METRIC_VALUE("gameobject_pool_allocated", (Trinity::ObjectPool<GameObject, 256>::GetStats().Allocated.load()));
+    TC_METRIC_VALUE("gameobject_pool_reused", (Trinity::ObjectPool<GameObject, 256>::GetStats().Reused.load()));
+
+    MMAP::MMapManager* mmmgr = MMAP::MMapFactory::createOrGetMMapManager();
+    TC_METRIC_VALUE("mmap_tile_memory", mmmgr->getTileMemory());
+    TC_METRIC_VALUE("mmap_tile_cache_hits", mmmgr->getTileCacheHits());
+    TC_METRIC_VALUE("mmap_tile_cache_misses", mmmgr->getTileCacheMisses());
+    TC_METRIC_VALUE("mmap_tile_cache_evictions", mmmgr->getTileCacheEvictions());
 }
 
 void World::ForceGameEventUpdate()
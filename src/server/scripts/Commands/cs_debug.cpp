@@ -42,8 +42,10 @@ EndScriptData */
 #include "ObjectMgr.h"
 #include "PhasingHandler.h"
 #include "RBAC.h"
+#include "SpellBenchmark.h"
 #include "SpellPackets.h"
 #include "Transport.h"
+#include "World.h"
 #include "WorldSession.h"
 #include <fstream>
 #include <limits>
@@ -119,6 +121,7 @@ public:
             { "movementforce", rbac::RBAC_PERM_COMMAND_DEBUG_MOVEMENT_FORCE,false, nullptr,                             "", debugMovementForceCommandTable },
             { "playercondition",rbac::RBAC_PERM_COMMAND_DEBUG,              false, &HandleDebugPlayerConditionCommand,  "" },
             { "maxItemLevel",   rbac::RBAC_PERM_COMMAND_DEBUG,              false, &HandleDebugMaxItemLevelCommand,     "" },
+            { "spellbench",     rbac::RBAC_PERM_COMMAND_DEBUG,              true,  &HandleDebugSpellBenchCommand,       "" },
         };
         static std::vector<ChatCommand> commandTable =
         {
@@ -1691,6 +1694,65 @@ public:
         handler->getSelectedPlayerOrSelf()->SetEffectiveLevelAndMaxItemLevel(effectiveLevel, maxItemLevel);
         return true;
     }
+
+    // USAGE: .debug spellbench #spellId[,#spellId...] [#casters] [#targets] [#ticks] [#seed]
+    // Replays a fixed cast sequence between synthetic creatures on a private copy of Eastern Kingdoms
+    // in Stormwind City, with its terrain and buildings but none of its spawns, console only:
+    // the benchmark drives Map::Update itself, which must not happen from a session updated by a map
+    static bool HandleDebugSpellBenchCommand(ChatHandler* handler, char const* args)
+    {
+        if (!*args)
+            return false;
+
+        if (handler->GetSession())
+        {
+            handler->SendSysMessage("The spell benchmark can only be run from the console.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        SpellBenchmarkParams params;
+
+        char* spellList = strtok((char*)args, " ");
+        char* casters = strtok(nullptr, " ");
+        char* targets = strtok(nullptr, " ");
+        char* ticks = strtok(nullptr, " ");
+        char* seed = strtok(nullptr, " ");
+
+        Tokenizer spellIds(spellList, ',');
+        for (char const* spellId : spellIds)
+            params.SpellIds.push_back(atoul(spellId));
+
+        if (casters)
+            params.CasterCount = atoul(casters);
+        if (targets)
+            params.TargetCount = atoul(targets);
+        if (ticks)
+            params.Ticks = atoul(ticks);
+        if (seed)
+            params.Seed = atoul(seed);
+
+        params.TickDiff = sWorld->getIntConfig(CONFIG_INTERVAL_MAPUPDATE);
+
+        Position center(-8913.23f, 554.633f, 93.7944f);     // Stormwind City
+
+        SpellBenchmarkResult result;
+        if (!SpellBenchmark::Run(0, center, params, result))
+        {
+            handler->SendSysMessage("Spell benchmark could not be started, check the spell ids and the creature template.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        uint64 totalTime = std::max<uint64>(result.CastTime + result.UpdateTime, 1);
+        handler->PSendSysMessage("Spell benchmark: %u casts (%u failed) over %u ticks, %u casters, %u targets, seed %u",
+            result.Casts, result.FailedCasts, params.Ticks, params.CasterCount, params.TargetCount, params.Seed);
+        handler->PSendSysMessage("Casts/sec: %.1f, setup: " UI64FMTD " us, cast phase: " UI64FMTD " us, map update phase: " UI64FMTD " us (" UI64FMTD " us per tick)",
+            double(result.Casts) * 1000000.0 / double(totalTime), result.SetupTime, result.CastTime, result.UpdateTime, totalTime / std::max<uint32>(params.Ticks, 1));
+        handler->PSendSysMessage("Spell pool: " UI64FMTD " allocated, " UI64FMTD " reused - Aura pool: " UI64FMTD " allocated, " UI64FMTD " reused",
+            result.SpellsAllocated, result.SpellsReused, result.AurasAllocated, result.AurasReused);
+        return true;
+    }
 };
 
 void AddSC_debug_commandscript()
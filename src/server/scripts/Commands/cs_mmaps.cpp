@@ -221,6 +221,8 @@ public:
 
         MMAP::MMapManager* manager = MMAP::MMapFactory::createOrGetMMapManager();
         handler->PSendSysMessage(" %u maps loaded with %u tiles overall", manager->getLoadedMapsCount(), manager->getLoadedTilesCount());
+        handler->PSendSysMessage(" tiles use " UI64FMTD " KB, idle tile reuses: " UI64FMTD ", reads: " UI64FMTD ", evictions: " UI64FMTD,
+            manager->getTileMemory() / 1024, manager->getTileCacheHits(), manager->getTileCacheMisses(), manager->getTileCacheEvictions());
 
         dtNavMesh const* navmesh = manager->GetNavMesh(terrainMapId);
         if (!navmesh)
@@ -91,12 +91,10 @@ bool DB2StorageBase::Load(std::string const& path, uint32 locale, char**& indexT
 {
     indexTable = nullptr;
     DB2FileLoader db2;
-    {
-        DB2FileSystemSource source(path + _fileName);
-        // Check if load was successful, only then continue
-        if (!db2.Load(&source, _loadInfo))
-            return false;
-    }
+    std::unique_ptr<DB2FileSource> source = Trinity::make_unique<DB2FileSystemSource>(path + _fileName);
+    // Check if load was successful, only then continue
+    if (!db2.Load(source.get(), _loadInfo))
+        return false;
 
     _fieldCount = db2.GetCols();
     _tableHash = db2.GetTableHash();
@@ -107,8 +105,7 @@ bool DB2StorageBase::Load(std::string const& path, uint32 locale, char**& indexT
 
     // load strings from db2 data
     if (!_stringPool.empty())
-        if (char* stringBlock = db2.AutoProduceStrings(indexTable, _indexTableSize, locale))
-            _stringPool.push_back(stringBlock);
+        LoadStrings(db2, source, locale, indexTable);
 
     db2.AutoProduceRecordCopies(_indexTableSize, indexTable, _dataTable);
 
@@ -123,19 +120,31 @@ bool DB2StorageBase::LoadStringsFrom(std::string const& path, uint32 locale, cha
         return false;
 
     DB2FileLoader db2;
-    DB2FileSystemSource source(path + _fileName);
+    std::unique_ptr<DB2FileSource> source = Trinity::make_unique<DB2FileSystemSource>(path + _fileName);
     // Check if load was successful, only then continue
-    if (!db2.Load(&source, _loadInfo))
+    if (!db2.Load(source.get(), _loadInfo))
         return false;
 
     // load strings from another locale db2 data
     if (_loadInfo->GetStringFieldCount(true))
-        if (char* stringBlock = db2.AutoProduceStrings(indexTable, _indexTableSize, locale))
-            _stringPool.push_back(stringBlock);
+        LoadStrings(db2, source, locale, indexTable);
 
     return true;
 }
 
+void DB2StorageBase::LoadStrings(DB2FileLoader& db2, std::unique_ptr<DB2FileSource>& source, uint32 locale, char** indexTable)
+{
+    // strings of mapped files are not copied, records keep pointing into the file (whose mapping is then kept)
+    // so the strings of a locale take no memory until they are sent to a client
+    if (db2.IsLoadedInPlace())
+    {
+        if (db2.AutoProduceStringsInPlace(indexTable, _indexTableSize, locale))
+            _stringSources.push_back(std::move(source));
+    }
+    else if (char* stringBlock = db2.AutoProduceStrings(indexTable, _indexTableSize, locale))
+        _stringPool.push_back(stringBlock);
+}
+
 void DB2StorageBase::LoadFromDB(char**& indexTable)
 {
     char* extraStringHolders = nullptr;
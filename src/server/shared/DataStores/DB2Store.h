@@ -21,9 +21,12 @@
 #include "Common.h"
 #include "Errors.h"
 #include "DBStorageIterator.h"
+#include <memory>
 #include <vector>
 
 class ByteBuffer;
+class DB2FileLoader;
+struct DB2FileSource;
 struct DB2LoadInfo;
 
 /// Interface class for common access
@@ -56,6 +59,10 @@ protected:
     void LoadFromDB(char**& indexTable);
     void LoadStringsFromDB(uint32 locale, char** indexTable);
 
+private:
+    void LoadStrings(DB2FileLoader& db2, std::unique_ptr<DB2FileSource>& source, uint32 locale, char** indexTable);
+
+protected:
     uint32 _tableHash;
     uint32 _layoutHash;
     std::string _fileName;
@@ -64,6 +71,7 @@ protected:
     char* _dataTable;
     char* _dataTableEx;
     std::vector<char*> _stringPool;
+    std::vector<std::unique_ptr<DB2FileSource>> _stringSources;  // mapped files that records point into
     uint32 _indexTableSize;
 };
 
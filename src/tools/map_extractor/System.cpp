@@ -23,16 +23,23 @@
 #include "DB2Meta.h"
 #include "DBFilesClientList.h"
 #include "ExtractorDB2LoadInfo.h"
+#include "SHA1.h"
 #include "StringFormat.h"
 #include "adt.h"
 #include "wdt.h"
 #include <CascLib.h>
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <deque>
 #include <fstream>
+#include <map>
+#include <mutex>
 #include <set>
+#include <sstream>
+#include <thread>
 #include <unordered_map>
 #include <cstdlib>
 #include <cstring>
@@ -98,6 +105,9 @@ float CONF_flat_liquid_delta_limit = 0.001f; // If max - min less this value - l
 
 uint32 CONF_Locale = 0;
 
+// Number of threads converting map tiles
+uint32 CONF_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
 #define CASC_LOCALES_COUNT 17
 
 char const* CascLocaleNames[CASC_LOCALES_COUNT] =
@@ -149,6 +159,7 @@ void Usage(char const* prg)
         "-e extract only MAP(1)/DBC(2)/Camera(4)/gt(8) - standard: all(15)\n"\
         "-f height stored as int (less map size but lost some accuracy) 1 by default\n"\
         "-l dbc locale\n"\
+        "-t number of threads used to convert map tiles - standard: all cores\n"\
         "Example: %s -f 0 -i \"c:\\games\\game\"\n", prg, prg);
     exit(1);
 }
@@ -163,6 +174,7 @@ void HandleArgs(int argc, char* arg[])
         // f - use float to int conversion
         // h - limit minimum height
         // l - dbc locale
+        // t - number of map conversion threads
         if (arg[c][0] != '-')
             Usage(arg[0]);
 
@@ -207,6 +219,16 @@ void HandleArgs(int argc, char* arg[])
                 else
                     Usage(arg[0]);
                 break;
+            case 't':
+                if (c + 1 < argc)                            // all ok
+                {
+                    CONF_threads = atoi(arg[c++ + 1]);
+                    if (!CONF_threads)
+                        Usage(arg[0]);
+                }
+                else
+                    Usage(arg[0]);
+                break;
             case 'h':
                 Usage(arg[0]);
                 break;
@@ -441,24 +463,24 @@ float selectUInt16StepStore(float maxDiff)
 {
     return 65535 / maxDiff;
 }
-// Temporary grid data store
-uint16 area_ids[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+// Temporary grid data store, one per worker thread
+thread_local uint16 area_ids[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
 
-float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
-uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint16 uint16_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
-uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint8  uint8_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+thread_local float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local float V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+thread_local uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local uint16 uint16_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+thread_local uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local uint8  uint8_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
 
-uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float liquid_height[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
-uint8 holes[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID][8];
+thread_local uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+thread_local uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+thread_local bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local float liquid_height[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+thread_local uint8 holes[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID][8];
 
-int16 flight_box_max[3][3];
-int16 flight_box_min[3][3];
+thread_local int16 flight_box_max[3][3];
+thread_local int16 flight_box_min[3][3];
 
 LiquidVertexFormatType adt_MH2O::GetLiquidVertexFormat(adt_liquid_instance const* liquidInstance) const
 {
@@ -494,13 +516,8 @@ bool TransformToHighRes(uint16 lowResHoles, uint8 hiResHoles[8])
     return *((uint64*)hiResHoles) != 0;
 }
 
-bool ConvertADT(std::string const& inputPath, std::string const& outputPath, int /*cell_y*/, int /*cell_x*/, uint32 build, bool ignoreDeepWater)
+bool ConvertADT(ChunkedFile& adt, std::string const& inputPath, std::string const& outputPath, int /*cell_y*/, int /*cell_x*/, uint32 build, bool ignoreDeepWater)
 {
-    ChunkedFile adt;
-
-    if (!adt.loadFile(CascStorage, inputPath))
-        return false;
-
     // Prepare map header
     map_fileheader map;
     map.mapMagic = *reinterpret_cast<uint32 const*>(MAP_MAGIC);
@@ -1067,10 +1084,77 @@ bool IsDeepWaterIgnored(uint32 mapId, uint32 x, uint32 y)
     return false;
 }
 
+struct MapTileJob
+{
+    std::string StoragePath;
+    std::string OutputFileName;
+    std::string ManifestKey;
+    uint32 X;
+    uint32 Y;
+    bool IgnoreDeepWater;
+};
+
+// Everything besides the adt file itself that changes the content of .map files
+std::string GetMapSettingsHash()
+{
+    std::ostringstream settings;
+    settings << MAP_VERSION_MAGIC << ' ' << CONF_allow_height_limit << ' ' << CONF_use_minHeight << ' ' << CONF_allow_float_to_int << ' '
+        << CONF_float_to_int8_limit << ' ' << CONF_float_to_int16_limit << ' ' << CONF_flat_height_delta_limit << ' ' << CONF_flat_liquid_delta_limit;
+
+    std::map<uint32, LiquidMaterialEntry> liquidMaterials(LiquidMaterials.begin(), LiquidMaterials.end());
+    for (auto const& liquidMaterial : liquidMaterials)
+        settings << ' ' << liquidMaterial.first << ':' << int32(liquidMaterial.second.LVF);
+
+    std::map<uint32, LiquidTypeEntry> liquidTypes(LiquidTypes.begin(), LiquidTypes.end());
+    for (auto const& liquidType : liquidTypes)
+        settings << ' ' << liquidType.first << ':' << uint32(liquidType.second.SoundBank) << ':' << uint32(liquidType.second.MaterialID);
+
+    return CalculateSHA1Hash(settings.str());
+}
+
+// maps/manifest.txt holds the hash of the settings on the first line, then one "<adt hash> <map file>" line per extracted tile
+std::unordered_map<std::string, std::string> LoadMapManifest(boost::filesystem::path const& path, std::string const& settingsHash)
+{
+    std::unordered_map<std::string, std::string> manifest;
+    std::ifstream file(path.string());
+    std::string line;
+    if (!file || !std::getline(file, line) || line != settingsHash)
+        return manifest;
+
+    while (std::getline(file, line))
+    {
+        std::size_t separator = line.find(' ');
+        if (separator != std::string::npos)
+            manifest[line.substr(separator + 1)] = line.substr(0, separator);
+    }
+
+    return manifest;
+}
+
+// the build is the only part of an unchanged tile that differs between client patches
+bool UpdateMapBuild(std::string const& fileName, uint32 build)
+{
+    std::fstream file(fileName, std::fstream::in | std::fstream::out | std::fstream::binary);
+    if (!file)
+        return false;
+
+    map_fileheader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.mapMagic != *reinterpret_cast<uint32 const*>(MAP_MAGIC) ||
+        header.versionMagic != *reinterpret_cast<uint32 const*>(MAP_VERSION_MAGIC))
+        return false;
+
+    if (header.buildMagic != build)
+    {
+        file.seekp(offsetof(map_fileheader, buildMagic));
+        file.write(reinterpret_cast<char const*>(&build), sizeof(build));
+    }
+
+    return bool(file);
+}
+
 void ExtractMaps(uint32 build)
 {
     std::string storagePath;
-    std::string outputFileName;
 
     printf("Extracting maps...\n");
 
@@ -1082,7 +1166,7 @@ void ExtractMaps(uint32 build)
 
     CreateDir(output_path / "maps");
 
-    printf("Convert map files\n");
+    std::vector<MapTileJob> jobs;
     for (std::size_t z = 0; z < map_ids.size(); ++z)
     {
         printf("Extract %s (" SZFMTD "/" SZFMTD ")                  \n", map_ids[z].name, z+1, map_ids.size());
@@ -1100,18 +1184,88 @@ void ExtractMaps(uint32 build)
                 if (!(chunk->As<wdt_MAIN>()->adt_list[y][x].flag & 0x1))
                     continue;
 
-                storagePath = Trinity::StringFormat("World\\Maps\\%s\\%s_%u_%u.adt", map_ids[z].name, map_ids[z].name, x, y);
-                outputFileName =  Trinity::StringFormat("%s/maps/%04u_%02u_%02u.map", output_path.string().c_str(), map_ids[z].id, y, x);
-                bool ignoreDeepWater = IsDeepWaterIgnored(map_ids[z].id, y, x);
-                ConvertADT(storagePath, outputFileName, y, x, build, ignoreDeepWater);
+                MapTileJob job;
+                job.StoragePath = Trinity::StringFormat("World\\Maps\\%s\\%s_%u_%u.adt", map_ids[z].name, map_ids[z].name, x, y);
+                job.ManifestKey = Trinity::StringFormat("%04u_%02u_%02u.map", map_ids[z].id, y, x);
+                job.OutputFileName = (output_path / "maps" / job.ManifestKey).string();
+                job.X = x;
+                job.Y = y;
+                job.IgnoreDeepWater = IsDeepWaterIgnored(map_ids[z].id, y, x);
+                jobs.push_back(std::move(job));
+            }
+        }
+    }
+
+    boost::filesystem::path manifestPath = output_path / "maps" / "manifest.txt";
+    std::string settingsHash = GetMapSettingsHash();
+    std::unordered_map<std::string, std::string> previousHashes = LoadMapManifest(manifestPath, settingsHash);
+    std::vector<std::string> hashes(jobs.size());
+
+    uint32 threadCount = std::min<uint32>(CONF_threads, std::max<uint32>(uint32(jobs.size()), 1));
+    printf("Convert map files (%u threads)\n", threadCount);
+
+    // tiles are converted in parallel, only reading from the casc storage is serialized
+    std::mutex cascLock;
+    std::mutex progressLock;
+    std::atomic<std::size_t> nextJob(0);
+    std::atomic<uint32> convertedCount(0);
+    std::atomic<uint32> unchangedCount(0);
+    std::size_t doneCount = 0;
+
+    auto worker = [&]()
+    {
+        for (std::size_t i = nextJob++; i < jobs.size(); i = nextJob++)
+        {
+            MapTileJob const& job = jobs[i];
+            ChunkedFile adt;
+            bool loaded;
+            {
+                std::lock_guard<std::mutex> lock(cascLock);
+                loaded = adt.loadFile(CascStorage, job.StoragePath);
+            }
+
+            if (loaded)
+            {
+                std::string hash = CalculateSHA1Hash(std::string(reinterpret_cast<char const*>(adt.GetData()), adt.GetDataSize()));
+                auto previousHash = previousHashes.find(job.ManifestKey);
+                if (previousHash != previousHashes.end() && previousHash->second == hash && UpdateMapBuild(job.OutputFileName, build))
+                {
+                    hashes[i] = std::move(hash);
+                    ++unchangedCount;
+                }
+                else if (ConvertADT(adt, job.StoragePath, job.OutputFileName, job.Y, job.X, build, job.IgnoreDeepWater))
+                {
+                    hashes[i] = std::move(hash);
+                    ++convertedCount;
+                }
             }
 
             // draw progress bar
-            printf("Processing........................%d%%\r", (100 * (y+1)) / WDT_MAP_SIZE);
+            std::lock_guard<std::mutex> lock(progressLock);
+            ++doneCount;
+            if ((100 * doneCount) / jobs.size() != (100 * (doneCount - 1)) / jobs.size())
+            {
+                printf("Processing........................" SZFMTD "%%\r", (100 * doneCount) / jobs.size());
+                fflush(stdout);
+            }
         }
-    }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32 i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+
+    worker();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    std::ofstream manifest(manifestPath.string(), std::ofstream::out | std::ofstream::trunc);
+    manifest << settingsHash << '\n';
+    for (std::size_t i = 0; i < jobs.size(); ++i)
+        if (!hashes[i].empty())
+            manifest << hashes[i] << ' ' << jobs[i].ManifestKey << '\n';
 
-    printf("\n");
+    printf("\nConverted %u map files, %u unchanged\n", convertedCount.load(), unchangedCount.load());
 }
 
 bool ExtractFile(CASC::FileHandle const& fileInArchive, std::string const& filename)
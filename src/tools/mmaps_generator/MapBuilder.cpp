@@ -21,7 +21,9 @@
 #include "MapTree.h"
 #include "ModelInstance.h"
 #include "PathCommon.h"
+#include "SHA1.h"
 #include "StringFormat.h"
+#include "Util.h"
 #include "VMapFactory.h"
 #include "VMapManager2.h"
 #include <DetourCommon.h>
@@ -46,7 +48,7 @@ namespace MMAP
         m_totalTiles         (0u),
         m_totalTilesProcessed(0u),
         m_rcContext          (NULL),
-        _cancelationToken    (false)
+        m_seedTileManifest   (false)
     {
         m_terrainBuilder = new TerrainBuilder(skipLiquid);
 
@@ -170,58 +172,90 @@ namespace MMAP
 
     void MapBuilder::WorkerThread()
     {
-        while (1)
+        dtNavMesh* navMesh = NULL;
+        uint32 navMeshMapId = uint32(-1);
+        TileInfo tileInfo;
+        while (_queue.Pop(tileInfo))
         {
-            uint32 mapId = 0;
-
-            _queue.WaitAndPop(mapId);
-
-            if (_cancelationToken)
-                return;
+            // tiles are queued map by map, the navmesh is only recreated when the map changes
+            if (!navMesh || navMeshMapId != tileInfo.m_mapId)
+            {
+                dtFreeNavMesh(navMesh);
+                navMesh = dtAllocNavMesh();
+                navMeshMapId = tileInfo.m_mapId;
+                if (!navMesh->init(&tileInfo.m_navMeshParams))
+                {
+                    printf("[Map %04u] Failed creating navmesh for tile [%02u,%02u]!\n", tileInfo.m_mapId, tileInfo.m_tileX, tileInfo.m_tileY);
+                    dtFreeNavMesh(navMesh);
+                    navMesh = NULL;
+                    ++m_totalTilesProcessed;
+                    continue;
+                }
+            }
 
-            buildMap(mapId);
+            buildTile(tileInfo.m_mapId, tileInfo.m_tileX, tileInfo.m_tileY, navMesh);
+            ++m_totalTilesProcessed;
         }
+
+        dtFreeNavMesh(navMesh);
     }
 
     void MapBuilder::buildAllMaps(unsigned int threads)
     {
         printf("Using %u threads to extract mmaps\n", threads);
 
-        for (unsigned int i = 0; i < threads; ++i)
-        {
-            _workerThreads.push_back(std::thread(&MapBuilder::WorkerThread, this));
-        }
+        loadTileManifest();
 
         m_tiles.sort([](MapTiles const& a, MapTiles const& b)
         {
             return a.m_tiles->size() > b.m_tiles->size();
         });
 
+        // navmesh parameters of every map are written up front, the workers then pick single tiles
+        // so the biggest continent is shared by all threads instead of being built by one of them
         for (TileList::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
         {
             uint32 mapId = it->m_mapId;
-            if (!shouldSkipMap(mapId))
+            if (shouldSkipMap(mapId) || it->m_tiles->empty())
+                continue;
+
+            dtNavMesh* navMesh = NULL;
+            buildNavMesh(mapId, navMesh);
+            if (!navMesh)
             {
-                if (threads > 0)
-                    _queue.Push(mapId);
-                else
-                    buildMap(mapId);
+                printf("[Map %04u] Failed creating navmesh!\n", mapId);
+                m_totalTilesProcessed += it->m_tiles->size();
+                continue;
             }
+
+            printf("[Map %04u] We have %u tiles.                          \n", mapId, (unsigned int)it->m_tiles->size());
+
+            TileInfo tileInfo;
+            tileInfo.m_mapId = mapId;
+            memcpy(&tileInfo.m_navMeshParams, navMesh->getParams(), sizeof(dtNavMeshParams));
+            for (uint32 tileId : *it->m_tiles)
+            {
+                StaticMapTree::unpackTileID(tileId, tileInfo.m_tileX, tileInfo.m_tileY);
+                _queue.Push(tileInfo);
+            }
+
+            dtFreeNavMesh(navMesh);
         }
 
-        while (!_queue.Empty())
+        for (unsigned int i = 0; i < threads; ++i)
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+            _workerThreads.push_back(std::thread(&MapBuilder::WorkerThread, this));
         }
 
-        _cancelationToken = true;
-
-        _queue.Cancel();
+        if (!threads)
+            WorkerThread();
 
         for (auto& thread : _workerThreads)
         {
             thread.join();
         }
+
+        saveTileManifest();
     }
 
     /**************************************************************************/
@@ -367,48 +401,9 @@ namespace MMAP
         dtFreeNavMesh(navMesh);
     }
 
-    /**************************************************************************/
-    void MapBuilder::buildMap(uint32 mapID)
-    {
-        std::set<uint32>* tiles = getTileList(mapID);
-
-        if (!tiles->empty())
-        {
-            // build navMesh
-            dtNavMesh* navMesh = NULL;
-            buildNavMesh(mapID, navMesh);
-            if (!navMesh)
-            {
-                printf("[Map %04i] Failed creating navmesh!\n", mapID);
-                m_totalTilesProcessed += tiles->size();
-                return;
-            }
-
-            // now start building mmtiles for each tile
-            printf("[Map %04i] We have %u tiles.                          \n", mapID, (unsigned int)tiles->size());
-            for (std::set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
-            {
-                uint32 tileX, tileY;
-
-                // unpack tile coords
-                StaticMapTree::unpackTileID((*it), tileX, tileY);
-
-                if (!shouldSkipTile(mapID, tileX, tileY))
-                    buildTile(mapID, tileX, tileY, navMesh);
-                ++m_totalTilesProcessed;
-            }
-
-            dtFreeNavMesh(navMesh);
-        }
-
-        printf("[Map %04u] Complete!\n", mapID);
-    }
-
     /**************************************************************************/
     void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh)
     {
-        printf("%u%% [Map %04i] Building tile [%02u,%02u]\n", percentageDone(m_totalTiles, m_totalTilesProcessed), mapID, tileX, tileY);
-
         MeshData meshData;
 
         // get heightmap data
@@ -439,8 +434,26 @@ namespace MMAP
 
         m_terrainBuilder->loadOffMeshConnections(mapID, tileX, tileY, meshData, m_offMeshFilePath);
 
+        // loading the geometry is cheap compared to building the tile from it
+        std::string inputHash;
+        if (m_tileManifestJournal.is_open())
+        {
+            inputHash = getTileInputHash(tileX, tileY, meshData, navMesh);
+            if (shouldSkipTile(mapID, tileX, tileY, inputHash))
+            {
+                printf("[Map %04u] [%02u,%02u]: Tile is up to date\n", mapID, tileX, tileY);
+                return;
+            }
+        }
+
+        printf("%u%% [Map %04i] Building tile [%02u,%02u]\n", percentageDone(m_totalTiles, m_totalTilesProcessed), mapID, tileX, tileY);
+
         // build navmesh tile
-        buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh);
+        TileBuildResult result = buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh);
+
+        // failed tiles are left out of the manifest so the next run retries them
+        if (!inputHash.empty() && result != TILE_BUILD_ERROR)
+            addTileToManifest(mapID, tileX, tileY, inputHash, result == TILE_BUILD_WRITTEN);
     }
 
     /**************************************************************************/
@@ -525,7 +538,7 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    void MapBuilder::buildMoveMapTile(uint32 mapID, uint32 tileX, uint32 tileY,
+    TileBuildResult MapBuilder::buildMoveMapTile(uint32 mapID, uint32 tileX, uint32 tileY,
         MeshData &meshData, float bmin[3], float bmax[3],
         dtNavMesh* navMesh)
     {
@@ -585,6 +598,8 @@ namespace MMAP
 
         // allocate subregions : tiles
         Tile* tiles = new Tile[TILES_PER_MAP * TILES_PER_MAP];
+        // a tile left without polygons by a failed step is an error, not an empty tile
+        bool subTileFailed = false;
 
         // Initialize per tile config.
         rcConfig tileCfg = config;
@@ -613,6 +628,7 @@ namespace MMAP
                 if (!tile.solid || !rcCreateHeightfield(m_rcContext, *tile.solid, tileCfg.width, tileCfg.height, tileCfg.bmin, tileCfg.bmax, tileCfg.cs, tileCfg.ch))
                 {
                     printf("%s Failed building heightfield!            \n", tileString.c_str());
+                    subTileFailed = true;
                     continue;
                 }
 
@@ -634,6 +650,7 @@ namespace MMAP
                 if (!tile.chf || !rcBuildCompactHeightfield(m_rcContext, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid, *tile.chf))
                 {
                     printf("%s Failed compacting heightfield!            \n", tileString.c_str());
+                    subTileFailed = true;
                     continue;
                 }
 
@@ -641,18 +658,21 @@ namespace MMAP
                 if (!rcErodeWalkableArea(m_rcContext, config.walkableRadius, *tile.chf))
                 {
                     printf("%s Failed eroding area!                    \n", tileString.c_str());
+                    subTileFailed = true;
                     continue;
                 }
 
                 if (!rcBuildDistanceField(m_rcContext, *tile.chf))
                 {
                     printf("%s Failed building distance field!         \n", tileString.c_str());
+                    subTileFailed = true;
                     continue;
                 }
 
                 if (!rcBuildRegions(m_rcContext, *tile.chf, tileCfg.borderSize, tileCfg.minRegionArea, tileCfg.mergeRegionArea))
                 {
                     printf("%s Failed building regions!                \n", tileString.c_str());
+                    subTileFailed = true;
                     continue;
                 }
 
@@ -660,6 +680,7 @@ namespace MMAP
                 if (!tile.cset || !rcBuildContours(m_rcContext, *tile.chf, tileCfg.maxSimplificationError, tileCfg.maxEdgeLen, *tile.cset))
                 {
                     printf("%s Failed building contours!               \n", tileString.c_str());
+                    subTileFailed = true;
                     continue;
                 }
 
@@ -668,6 +689,7 @@ namespace MMAP
                 if (!tile.pmesh || !rcBuildPolyMesh(m_rcContext, *tile.cset, tileCfg.maxVertsPerPoly, *tile.pmesh))
                 {
                     printf("%s Failed building polymesh!               \n", tileString.c_str());
+                    subTileFailed = true;
                     continue;
                 }
 
@@ -675,6 +697,7 @@ namespace MMAP
                 if (!tile.dmesh || !rcBuildPolyMeshDetail(m_rcContext, *tile.pmesh, *tile.chf, tileCfg.detailSampleDist, tileCfg.detailSampleMaxError, *tile.dmesh))
                 {
                     printf("%s Failed building polymesh detail!        \n", tileString.c_str());
+                    subTileFailed = true;
                     continue;
                 }
 
@@ -701,7 +724,7 @@ namespace MMAP
             delete[] pmmerge;
             delete[] dmmerge;
             delete[] tiles;
-            return;
+            return TILE_BUILD_ERROR;
         }
         rcMergePolyMeshes(m_rcContext, pmmerge, nmerge, *iv.polyMesh);
 
@@ -712,7 +735,7 @@ namespace MMAP
             delete[] pmmerge;
             delete[] dmmerge;
             delete[] tiles;
-            return;
+            return TILE_BUILD_ERROR;
         }
         rcMergePolyMeshDetails(m_rcContext, dmmerge, nmerge, *iv.polyMeshDetail);
 
@@ -772,6 +795,7 @@ namespace MMAP
         // will hold final navmesh
         unsigned char* navData = NULL;
         int navDataSize = 0;
+        TileBuildResult result = TILE_BUILD_ERROR;
 
         do
         {
@@ -794,6 +818,8 @@ namespace MMAP
 
                 // message is an annoyance
                 //printf("%sNo vertices to build tile!              \n", tileString.c_str());
+                if (!subTileFailed)
+                    result = TILE_BUILD_EMPTY;
                 break;
             }
             if (!params.polyCount || !params.polys ||
@@ -803,6 +829,8 @@ namespace MMAP
                 // keep in mind that we do output those into debug info
                 // drop tiles with only exact count - some tiles may have geometry while having less tiles
                 printf("%s No polygons to build on tile!              \n", tileString.c_str());
+                if (!subTileFailed)
+                    result = TILE_BUILD_EMPTY;
                 break;
             }
             if (!params.detailMeshes || !params.detailVerts || !params.detailTris)
@@ -856,6 +884,7 @@ namespace MMAP
 
             // now that tile is written to disk, we can unload it
             navMesh->removeTile(tileRef, NULL, NULL);
+            result = TILE_BUILD_WRITTEN;
         }
         while (0);
 
@@ -872,6 +901,8 @@ namespace MMAP
             iv.generateObjFile(mapID, tileX, tileY, meshData);
             iv.writeIV(mapID, tileX, tileY);
         }
+
+        return result;
     }
 
     /**************************************************************************/
@@ -1079,7 +1110,30 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    bool MapBuilder::shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY)
+    bool MapBuilder::shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY, std::string const& inputHash)
+    {
+        auto entry = m_tileManifest.find(Trinity::StringFormat("%04u%02i%02i.mmtile", mapID, tileY, tileX));
+        if (entry == m_tileManifest.end())
+        {
+            // first incremental run over an existing output directory, trust the tiles built without a manifest
+            if (!m_seedTileManifest || !isTileFileValid(mapID, tileX, tileY))
+                return false;
+
+            addTileToManifest(mapID, tileX, tileY, inputHash, true);
+            return true;
+        }
+
+        if (entry->second.m_inputHash != inputHash)
+            return false;
+
+        // same input as a tile that had nothing to build last time
+        if (!entry->second.m_hasMesh)
+            return true;
+
+        return isTileFileValid(mapID, tileX, tileY);
+    }
+
+    bool MapBuilder::isTileFileValid(uint32 mapID, uint32 tileX, uint32 tileY)
     {
         char fileName[255];
         sprintf(fileName, "mmaps/%04u%02i%02i.mmtile", mapID, tileY, tileX);
@@ -1102,6 +1156,83 @@ namespace MMAP
         return true;
     }
 
+    /**************************************************************************/
+    void MapBuilder::loadTileManifest()
+    {
+        // debug output is only generated by tiles that are actually built
+        if (m_debugOutput)
+            return;
+
+        // one "<input hash> <tile file> <has mesh>" line per built tile, later lines replace earlier ones
+        std::ifstream file("mmaps/manifest.txt");
+        m_seedTileManifest = !file.is_open();
+
+        std::string inputHash, tileName;
+        int hasMesh;
+        while (file >> inputHash >> tileName >> hasMesh)
+            m_tileManifest[tileName] = { inputHash, hasMesh != 0 };
+
+        // tiles are appended as soon as they are done so an interrupted run keeps its progress
+        m_tileManifestJournal.open("mmaps/manifest.txt", std::ofstream::out | std::ofstream::app);
+    }
+
+    void MapBuilder::saveTileManifest()
+    {
+        if (!m_tileManifestJournal.is_open())
+            return;
+
+        m_tileManifestJournal.close();
+
+        for (auto const& tile : m_builtTiles)
+            m_tileManifest[tile.first] = tile.second;
+
+        std::ofstream file("mmaps/manifest.txt", std::ofstream::out | std::ofstream::trunc);
+        for (auto const& tile : m_tileManifest)
+            file << tile.second.m_inputHash << ' ' << tile.first << ' ' << tile.second.m_hasMesh << '\n';
+    }
+
+    void MapBuilder::addTileToManifest(uint32 mapID, uint32 tileX, uint32 tileY, std::string const& inputHash, bool hasMesh)
+    {
+        std::string tileName = Trinity::StringFormat("%04u%02i%02i.mmtile", mapID, tileY, tileX);
+
+        std::lock_guard<std::mutex> lock(m_tileManifestLock);
+        m_builtTiles[tileName] = { inputHash, hasMesh };
+        m_tileManifestJournal << inputHash << ' ' << tileName << ' ' << hasMesh << std::endl;
+    }
+
+    std::string MapBuilder::getTileInputHash(uint32 tileX, uint32 tileY, MeshData const& meshData, dtNavMesh const* navMesh) const
+    {
+        SHA1Hash hash;
+
+        // everything besides the geometry that ends up in the tile
+        std::string settings = Trinity::StringFormat("%u %u %u %u %u %f %u %u %f %f %f", MMAP_VERSION, uint32(DT_NAVMESH_VERSION), tileX, tileY,
+            uint32(m_terrainBuilder->usesLiquids()), m_maxWalkableAngle, uint32(m_bigBaseUnit), uint32(navMesh->getMaxTiles()),
+            navMesh->getParams()->orig[0], navMesh->getParams()->orig[1], navMesh->getParams()->orig[2]);
+        hash.UpdateData(settings);
+
+        auto addArray = [&hash](auto const& array)
+        {
+            uint32 size = uint32(array.size());
+            hash.UpdateData(reinterpret_cast<uint8 const*>(&size), sizeof(size));
+            if (size)
+                hash.UpdateData(reinterpret_cast<uint8 const*>(array.getCArray()), int(size * sizeof(*array.getCArray())));
+        };
+
+        addArray(meshData.solidVerts);
+        addArray(meshData.solidTris);
+        addArray(meshData.liquidVerts);
+        addArray(meshData.liquidTris);
+        addArray(meshData.liquidType);
+        addArray(meshData.offMeshConnections);
+        addArray(meshData.offMeshConnectionRads);
+        addArray(meshData.offMeshConnectionDirs);
+        addArray(meshData.offMeshConnectionsAreas);
+        addArray(meshData.offMeshConnectionsFlags);
+
+        hash.Finalize();
+        return ByteArrayToHexStr(hash.GetDigest(), hash.GetLength());
+    }
+
     /**************************************************************************/
     uint32 MapBuilder::percentageDone(uint32 totalTiles, uint32 totalTilesBuilt)
     {
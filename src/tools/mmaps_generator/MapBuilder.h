@@ -24,7 +24,10 @@
 #include <map>
 #include <list>
 #include <atomic>
+#include <fstream>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 
 #include "TerrainBuilder.h"
 #include "IntermediateValues.h"
@@ -55,6 +58,29 @@ namespace MMAP
 
     typedef std::list<MapTiles> TileList;
 
+    struct TileInfo
+    {
+        TileInfo() : m_mapId(uint32(-1)), m_tileX(), m_tileY(), m_navMeshParams() {}
+
+        uint32 m_mapId;
+        uint32 m_tileX;
+        uint32 m_tileY;
+        dtNavMeshParams m_navMeshParams;
+    };
+
+    enum TileBuildResult
+    {
+        TILE_BUILD_WRITTEN,             // .mmtile was written
+        TILE_BUILD_EMPTY,               // the geometry has no walkable polygons, nothing to write
+        TILE_BUILD_ERROR                // building or writing the tile failed
+    };
+
+    struct TileManifestEntry
+    {
+        std::string m_inputHash;        // geometry and settings the tile was built from
+        bool m_hasMesh;                 // false when the tile had no polygons and no .mmtile was written
+    };
+
     struct Tile
     {
         Tile() : chf(NULL), solid(NULL), cset(NULL), pmesh(NULL), dmesh(NULL) {}
@@ -88,14 +114,13 @@ namespace MMAP
 
             ~MapBuilder();
 
-            // builds all mmap tiles for the specified map id (ignores skip settings)
-            void buildMap(uint32 mapID);
             void buildMeshFromFile(char* name);
 
             // builds an mmap tile for the specified map and its mesh
             void buildSingleTile(uint32 mapID, uint32 tileX, uint32 tileY);
 
             // builds list of maps, then builds all of mmap tiles (based on the skip settings)
+            // tiles whose input geometry did not change since the last run are skipped
             void buildAllMaps(unsigned int threads);
 
             void WorkerThread();
@@ -110,7 +135,7 @@ namespace MMAP
             void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh);
 
             // move map building
-            void buildMoveMapTile(uint32 mapID,
+            TileBuildResult buildMoveMapTile(uint32 mapID,
                 uint32 tileX,
                 uint32 tileY,
                 MeshData &meshData,
@@ -125,7 +150,14 @@ namespace MMAP
 
             bool shouldSkipMap(uint32 mapID);
             bool isTransportMap(uint32 mapID);
-            bool shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY);
+            bool shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY, std::string const& inputHash);
+            bool isTileFileValid(uint32 mapID, uint32 tileX, uint32 tileY);
+
+            // incremental builds
+            void loadTileManifest();
+            void saveTileManifest();
+            void addTileToManifest(uint32 mapID, uint32 tileX, uint32 tileY, std::string const& inputHash, bool hasMesh);
+            std::string getTileInputHash(uint32 tileX, uint32 tileY, MeshData const& meshData, dtNavMesh const* navMesh) const;
 
             uint32 percentageDone(uint32 totalTiles, uint32 totalTilesDone);
 
@@ -151,8 +183,16 @@ namespace MMAP
             rcContext* m_rcContext;
 
             std::vector<std::thread> _workerThreads;
-            ProducerConsumerQueue<uint32> _queue;
-            std::atomic<bool> _cancelationToken;
+            ProducerConsumerQueue<TileInfo> _queue;
+
+            // tiles built by previous runs, read only while workers are running
+            std::unordered_map<std::string, TileManifestEntry> m_tileManifest;
+            // tiles built by this run, also appended to the manifest file as soon as they are done
+            std::unordered_map<std::string, TileManifestEntry> m_builtTiles;
+            std::ofstream m_tileManifestJournal;
+            std::mutex m_tileManifestLock;
+            // no manifest existed yet, tiles already on disk are adopted instead of rebuilt
+            bool m_seedTileManifest;
     };
 }
 
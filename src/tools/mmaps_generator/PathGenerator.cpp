@@ -367,10 +367,8 @@ int main(int argc, char** argv)
         builder.buildMeshFromFile(file);
     else if (tileX > -1 && tileY > -1 && mapnum >= 0)
         builder.buildSingleTile(mapnum, tileX, tileY);
-    else if (mapnum >= 0)
-        builder.buildMap(uint32(mapnum));
     else
-        builder.buildAllMaps(threads);
+        builder.buildAllMaps(threads);                      // limited to mapnum when it was given
 
     VMAP::VMapFactory::clear();
 
@@ -23,6 +23,7 @@
 #include "ModelInstance.h"
 #include "VMapFactory.h"
 #include "VMapManager2.h"
+#include <memory>
 
 // ******************************************
 // Map file format defines
@@ -84,6 +85,23 @@ namespace MMAP
     TerrainBuilder::TerrainBuilder(bool skipLiquid) : m_skipLiquid (skipLiquid){ }
     TerrainBuilder::~TerrainBuilder() { }
 
+    VMapManager2* TerrainBuilder::getVMapManager()
+    {
+        // a map tree only holds one set of loaded tiles, so each thread needs its own trees
+        // the idle models let neighbouring tiles built by the same thread share their model files
+        thread_local std::unique_ptr<VMapManager2> vmapManager;
+        if (!vmapManager)
+        {
+            VMapManager2* globalManager = static_cast<VMapManager2*>(VMapFactory::createOrGetVMapManager());
+            vmapManager = Trinity::make_unique<VMapManager2>();
+            vmapManager->InitializeThreadUnsafe(globalManager->getChildMapData());
+            vmapManager->GetLiquidFlagsPtr = globalManager->GetLiquidFlagsPtr;
+            vmapManager->setIdleModelMemoryLimit(128 * 1024 * 1024);
+        }
+
+        return vmapManager.get();
+    }
+
     /**************************************************************************/
     void TerrainBuilder::getLoopVars(Spot portion, int &loopStart, int &loopEnd, int &loopInc)
     {
@@ -638,7 +656,7 @@ namespace MMAP
     /**************************************************************************/
     bool TerrainBuilder::loadVMap(uint32 mapID, uint32 tileX, uint32 tileY, MeshData &meshData)
     {
-        VMapManager2* vmapManager = static_cast<VMapManager2*>(VMapFactory::createOrGetVMapManager());
+        VMapManager2* vmapManager = getVMapManager();
         int result = vmapManager->loadSingleMap(mapID, "vmaps", tileX, tileY);
         bool retval = false;
 
@@ -712,8 +730,8 @@ namespace MMAP
                         liquid->getPosInfo(tilesX, tilesY, corner);
                         vertsX = tilesX + 1;
                         vertsY = tilesY + 1;
-                        uint8* flags = liquid->GetFlagsStorage();
-                        float* data = liquid->GetHeightStorage();
+                        uint8 const* flags = liquid->GetFlagsStorage();
+                        float const* data = liquid->GetHeightStorage();
                         uint8 type = NAV_AREA_EMPTY;
 
                         // convert liquid type to NavTerrain
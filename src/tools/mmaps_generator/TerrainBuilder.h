@@ -26,6 +26,11 @@
 #include <G3D/Vector3.h>
 #include <G3D/Matrix3.h>
 
+namespace VMAP
+{
+    class VMapManager2;
+}
+
 namespace MMAP
 {
     enum Spot
@@ -104,6 +109,9 @@ namespace MMAP
             /// Controls whether liquids are loaded
             bool m_skipLiquid;
 
+            /// Vmap manager of the calling thread, workers load tiles of the same map at the same time
+            static VMAP::VMapManager2* getVMapManager();
+
             /// Load the map terrain from file
             bool loadHeightMap(uint32 mapID, uint32 tileX, uint32 tileY, G3D::Array<float> &vertices, G3D::Array<int> &triangles, Spot portion);
 